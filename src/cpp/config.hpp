@@ -15,6 +15,7 @@
 //   - Added DB-internal instrumentation toggle
 // =============================================================================
 
+#include <cctype>
 #include <cstdint>
 #include <cstdlib>
 #include <string>
@@ -274,6 +275,193 @@ struct MetricsTraceConfig {
     std::string sasl_password;   // from env KAFKA_PASSWORD or config
 };
 
+// PostgreSQL storage-strategy variant for the lab tables (PostgreSQL only).
+// Applied to the TOAST-able columns (BYTEA / JSONB / TEXT) after CREATE TABLE.
+struct PgStorageVariant {
+    std::string name;         // result tag; derived from the settings if empty
+    std::string storage;      // PLAIN | MAIN | EXTERNAL | EXTENDED, "" = type default
+    std::string compression;  // pglz | lz4, "" = default_toast_compression
+    int fillfactor = 0;       // 10..100, 0 = default (100)
+
+    std::string label() const {
+        if (!name.empty()) return name;
+        std::string l;
+        for (char c : storage) l += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        if (!compression.empty()) l += (l.empty() ? "" : "_") + compression;
+        if (fillfactor > 0) l += (l.empty() ? "ff" : "_ff") + std::to_string(fillfactor);
+        return l.empty() ? "default" : l;
+    }
+};
+
+// PostgreSQL / CockroachDB client tuning (libpq, shared by both systems)
+struct PostgresTuning {
+    // Per-file stages: max requests in flight in libpq pipeline mode.
+    // 0 or 1 = synchronous round trip per file (original behaviour).
+    int pipeline_depth = 0;
+
+    // Bulk stages: COPY BINARY send buffer; tuples are streamed to the
+    // server whenever this much data is staged (bounds client memory).
+    int64_t copy_buffer_bytes = 1024 * 1024;
+
+    // Per-file delete: primary keys fetched per keyset batch (bounds client
+    // memory independent of table size). Deletes use pipeline_depth as well.
+    int delete_fetch_size = 10000;
+
+    // Load stages: connections (one thread each) the input is partitioned
+    // across. 1 = single connection (original behaviour).
+    int parallelism = 1;
+
+    // CockroachDB bulk stages: rows (and payload bytes) per multi-row INSERT
+    // transaction, retried on 40001 via SAVEPOINT cockroach_restart.
+    // crdb_batch_rows = 0 keeps the COPY path.
+    int crdb_batch_rows = 128;
+    int64_t crdb_batch_bytes = 16LL * 1024 * 1024;
+    int crdb_max_retries = 50;
+    // Connect parallel workers to the live nodes from crdb_internal.gossip_nodes
+    bool crdb_spread_gateways = true;
+
+    // Schema-variant dimension: every payload type is run once per variant
+    // (empty = default tables only). Ignored by CockroachDB.
+    std::vector<PgStorageVariant> storage_variants;
+
+    // PostgreSQL layout: hash-partition files (by partition_key: "sha256" or
+    // "id") and the native tables (by primary key) into this many partitions.
+    // 0 = plain tables. Maintenance then runs VACUUM FULL / REINDEX per
+    // partition on maintenance_parallelism connections.
+    int hash_partitions = 0;
+    std::string partition_key = "sha256";
+    int maintenance_parallelism = 4;
+};
+
+// Redis client tuning (hiredis)
+struct RedisTuning {
+    // Load stages: commands queued per pipeline flush (redisAppendCommandArgv,
+    // replies read back with redisGetReply). 0 or 1 = one round trip per key.
+    int pipeline_depth = 0;
+
+    // Flush earlier once this much argument data is queued (bounds the
+    // client output buffer for large values)
+    int64_t pipeline_bytes = 4LL * 1024 * 1024;
+
+    // Route keys by CLUSTER SLOTS (one connection + thread per master);
+    // ignored when the server has cluster support disabled
+    bool cluster_routing = true;
+    // Retry rounds for MOVED/ASK redirected commands
+    int max_redirects = 5;
+
+    // Per-file delete: UNLINK pipelined with the SCAN of each master.
+    // delete_per_key_latency = one UNLINK per key (per-key Stage 3 latency);
+    // otherwise multi-key UNLINKs of up to delete_batch keys of one hash slot.
+    bool delete_per_key_latency = true;
+    int delete_batch = 1000;
+
+    // Size probe: pipelined MEMORY USAGE on a deterministic key sample.
+    // The rate is raised until the 95% relative error of the estimate is
+    // within size_error_bound (rate 1.0 = every key, exact); a sample of
+    // fewer than 30 keys is never trusted, the rate is raised first.
+    double size_sample_rate = 1.0;
+    double size_error_bound = 0.01;
+    int memory_usage_samples = 5;  // MEMORY USAGE ... SAMPLES (0 = all elements)
+
+    // Native-mode record encodings, each run as its own variant (empty =
+    // "hash" only): "hash" (HSET per record), "listpack" (records bucketed
+    // into small hashes that stay listpack-encoded), "json" (SET of a JSON
+    // document per record), "stream" (XADD per record into one stream).
+    std::vector<std::string> native_encodings;
+    // Fallback for hash-max-listpack-entries when CONFIG GET is not allowed
+    int listpack_entries = 128;
+};
+
+// One Kafka producer configuration of the profile dimension
+struct KafkaProducerProfile {
+    std::string name;         // result tag; derived from the settings if empty
+    std::string compression;  // none | gzip | snappy | lz4 | zstd, "" = librdkafka default
+    int linger_ms = -1;       // linger.ms, -1 = librdkafka default
+    int batch_size = 0;       // batch.size in bytes, 0 = librdkafka default
+    std::string acks;         // "" = KafkaTuning::acks
+
+    std::string label() const {
+        if (!name.empty()) return name;
+        std::string l = compression;
+        if (linger_ms >= 0) l += (l.empty() ? "l" : "_l") + std::to_string(linger_ms);
+        if (batch_size > 0) l += (l.empty() ? "b" : "_b") + std::to_string(batch_size);
+        if (!acks.empty()) l += (l.empty() ? "acks" : "_acks") + acks;
+        return l.empty() ? "default" : l;
+    }
+};
+
+// Kafka producer tuning (librdkafka)
+struct KafkaTuning {
+    // Producer acks: "all" (full ISR), "1" (leader only) or "0" (none; the
+    // delivery report then only confirms the send)
+    std::string acks = "all";
+
+    // Per-message latency = producev() to delivery report (broker ack).
+    // latency_breakdown also records the client-side enqueue share
+    // (producev + poll) as enqueue_latency.
+    bool latency_breakdown = false;
+
+    // rd_kafka_flush() wait at the end of a load stage; messages still
+    // unacknowledged then are purged and counted as failed
+    int flush_timeout_ms = 30000;
+
+    // Blob stages: mmap each dataset file and produce it by reference (no
+    // RD_KAFKA_MSG_F_COPY, no read() into a buffer). Mappings are released
+    // by their delivery report; at most max_inflight_bytes are outstanding.
+    bool zero_copy = false;
+    int64_t max_inflight_bytes = 256LL * 1024 * 1024;
+
+    // Producer-profile dimension: every payload type is run once per profile
+    // with a freshly created producer (empty = one run with the defaults).
+    // A "producer_matrix" object in the config expands to the cross product
+    // of its compression / linger_ms / batch_size / acks lists; an empty
+    // object adds nothing.
+    std::vector<KafkaProducerProfile> producer_profiles;
+
+    // Per-file delete: DeleteRecords moving each partition's low watermark
+    // by delete_step records per request (1 = one request per record offset)
+    int64_t delete_step = 1;
+
+    // Compacted lab topics (cleanup.policy=compact) keyed by payload SHA-256:
+    // log compaction is Kafka's dedup path. Maintenance rolls the segments
+    // (compaction_segment_ms, not part of the timed stage) and polls the
+    // log size every compaction_poll_ms until it has not changed for
+    // compaction_stable_polls polls in a row, at most compaction_wait_s.
+    bool compacted_topics = false;
+    int compaction_segment_ms = 60000;
+    int compaction_poll_ms = 5000;
+    int compaction_stable_polls = 3;
+    int compaction_wait_s = 600;
+};
+
+// MinIO / S3 client tuning (libcurl)
+struct MinioTuning {
+    // Blob load stages: PUTs kept in flight on one curl_multi (bodies
+    // streamed from the files). Per-file insert always runs one at a time
+    // so its latencies stay unqueued.
+    int upload_concurrency = 32;
+
+    // Files of at least multipart_threshold_mb MiB are uploaded as S3
+    // multipart uploads in part_size_mb parts (0 = always one PUT). The part
+    // size shapes MinIO's erasure-coded layout, so blob runs are tagged with
+    // it as their variant (e.g. part16m); part_sizes_mb runs every payload
+    // type once per listed size instead.
+    int multipart_threshold_mb = 64;
+    int part_size_mb = 16;
+    std::vector<int> part_sizes_mb;
+
+    // Send bodies as UNSIGNED-PAYLOAD: no client-side SHA-256 at all, and no
+    // x-amz-meta-sha256 fingerprint on the objects. Default: the payload's
+    // SHA-256 is computed once and used for both.
+    bool unsigned_payload = false;
+
+    // Per-file delete: delete_per_object_latency = one DELETE per object
+    // (per-object Stage 3 latency); otherwise DeleteObjects requests of up
+    // to delete_batch (max 1000) keys. Cleanup always deletes in batches.
+    bool delete_per_object_latency = true;
+    int delete_batch = 1000;
+};
+
 // Git export configuration (commit+push results before cleanup)
 struct GitExportConfig {
     std::string remote_name = "gitlab";
@@ -329,6 +517,14 @@ struct ExperimentConfig {
     // Git export (commit+push results before cleanup)
     GitExportConfig git_export;
 
+    // libpq client tuning for PostgreSQL and CockroachDB
+    PostgresTuning postgres;
+
+    // hiredis client tuning
+    RedisTuning redis;
+    KafkaTuning kafka;
+    MinioTuning minio;
+
     // Behavior
     bool dry_run = false;
     bool reset_schema_after_run = true;  // ALWAYS reset lab schema!
@@ -525,6 +721,96 @@ inline ExperimentConfig ExperimentConfig::from_json(const std::string& path) {
         cfg.metrics_trace.sasl_password = mt.value("sasl_password", cfg.metrics_trace.sasl_password);
     }
 
+    if (j.contains("postgres")) {
+        auto& pg = j["postgres"];
+        cfg.postgres.pipeline_depth = pg.value("pipeline_depth", cfg.postgres.pipeline_depth);
+        cfg.postgres.copy_buffer_bytes = pg.value("copy_buffer_bytes", cfg.postgres.copy_buffer_bytes);
+        cfg.postgres.delete_fetch_size = pg.value("delete_fetch_size", cfg.postgres.delete_fetch_size);
+        cfg.postgres.parallelism = pg.value("parallelism", cfg.postgres.parallelism);
+        cfg.postgres.crdb_batch_rows = pg.value("crdb_batch_rows", cfg.postgres.crdb_batch_rows);
+        cfg.postgres.crdb_batch_bytes = pg.value("crdb_batch_bytes", cfg.postgres.crdb_batch_bytes);
+        cfg.postgres.crdb_max_retries = pg.value("crdb_max_retries", cfg.postgres.crdb_max_retries);
+        cfg.postgres.crdb_spread_gateways = pg.value("crdb_spread_gateways", cfg.postgres.crdb_spread_gateways);
+        cfg.postgres.hash_partitions = pg.value("hash_partitions", cfg.postgres.hash_partitions);
+        cfg.postgres.partition_key = pg.value("partition_key", cfg.postgres.partition_key);
+        cfg.postgres.maintenance_parallelism = pg.value("maintenance_parallelism", cfg.postgres.maintenance_parallelism);
+        if (pg.contains("storage_variants")) {
+            for (const auto& sv : pg["storage_variants"]) {
+                PgStorageVariant v;
+                v.name = sv.value("name", "");
+                v.storage = sv.value("storage", "");
+                v.compression = sv.value("compression", "");
+                v.fillfactor = sv.value("fillfactor", 0);
+                cfg.postgres.storage_variants.push_back(v);
+            }
+        }
+    }
+
+    if (j.contains("redis")) {
+        auto& rd = j["redis"];
+        cfg.redis.pipeline_depth = rd.value("pipeline_depth", cfg.redis.pipeline_depth);
+        cfg.redis.pipeline_bytes = rd.value("pipeline_bytes", cfg.redis.pipeline_bytes);
+        cfg.redis.cluster_routing = rd.value("cluster_routing", cfg.redis.cluster_routing);
+        cfg.redis.max_redirects = rd.value("max_redirects", cfg.redis.max_redirects);
+        cfg.redis.delete_per_key_latency = rd.value("delete_per_key_latency", cfg.redis.delete_per_key_latency);
+        cfg.redis.delete_batch = rd.value("delete_batch", cfg.redis.delete_batch);
+        cfg.redis.size_sample_rate = rd.value("size_sample_rate", cfg.redis.size_sample_rate);
+        cfg.redis.size_error_bound = rd.value("size_error_bound", cfg.redis.size_error_bound);
+        cfg.redis.memory_usage_samples = rd.value("memory_usage_samples", cfg.redis.memory_usage_samples);
+        cfg.redis.native_encodings = rd.value("native_encodings", cfg.redis.native_encodings);
+        cfg.redis.listpack_entries = rd.value("listpack_entries", cfg.redis.listpack_entries);
+    }
+
+    if (j.contains("kafka")) {
+        auto& kf = j["kafka"];
+        cfg.kafka.acks = kf.value("acks", cfg.kafka.acks);
+        cfg.kafka.latency_breakdown = kf.value("latency_breakdown", cfg.kafka.latency_breakdown);
+        cfg.kafka.flush_timeout_ms = kf.value("flush_timeout_ms", cfg.kafka.flush_timeout_ms);
+        cfg.kafka.zero_copy = kf.value("zero_copy", cfg.kafka.zero_copy);
+        cfg.kafka.max_inflight_bytes = kf.value("max_inflight_bytes", cfg.kafka.max_inflight_bytes);
+        cfg.kafka.delete_step = kf.value("delete_step", cfg.kafka.delete_step);
+        cfg.kafka.compacted_topics = kf.value("compacted_topics", cfg.kafka.compacted_topics);
+        cfg.kafka.compaction_segment_ms = kf.value("compaction_segment_ms", cfg.kafka.compaction_segment_ms);
+        cfg.kafka.compaction_poll_ms = kf.value("compaction_poll_ms", cfg.kafka.compaction_poll_ms);
+        cfg.kafka.compaction_stable_polls = kf.value("compaction_stable_polls", cfg.kafka.compaction_stable_polls);
+        cfg.kafka.compaction_wait_s = kf.value("compaction_wait_s", cfg.kafka.compaction_wait_s);
+        if (kf.contains("producer_profiles")) {
+            for (const auto& pp : kf["producer_profiles"]) {
+                KafkaProducerProfile p;
+                p.name = pp.value("name", "");
+                p.compression = pp.value("compression", "");
+                p.linger_ms = pp.value("linger_ms", -1);
+                p.batch_size = pp.value("batch_size", 0);
+                p.acks = pp.value("acks", "");
+                cfg.kafka.producer_profiles.push_back(p);
+            }
+        }
+        if (kf.contains("producer_matrix") && !kf["producer_matrix"].empty()) {
+            // Missing axes keep the default (one value)
+            auto& m = kf["producer_matrix"];
+            auto compressions = m.value("compression", std::vector<std::string>{""});
+            auto lingers = m.value("linger_ms", std::vector<int>{-1});
+            auto batches = m.value("batch_size", std::vector<int>{0});
+            auto acks = m.value("acks", std::vector<std::string>{""});
+            for (const auto& c : compressions)
+                for (int l : lingers)
+                    for (int b : batches)
+                        for (const auto& a : acks)
+                            cfg.kafka.producer_profiles.push_back({"", c, l, b, a});
+        }
+    }
+
+    if (j.contains("minio")) {
+        auto& mn = j["minio"];
+        cfg.minio.upload_concurrency = mn.value("upload_concurrency", cfg.minio.upload_concurrency);
+        cfg.minio.multipart_threshold_mb = mn.value("multipart_threshold_mb", cfg.minio.multipart_threshold_mb);
+        cfg.minio.part_size_mb = mn.value("part_size_mb", cfg.minio.part_size_mb);
+        cfg.minio.part_sizes_mb = mn.value("part_sizes_mb", cfg.minio.part_sizes_mb);
+        cfg.minio.unsigned_payload = mn.value("unsigned_payload", cfg.minio.unsigned_payload);
+        cfg.minio.delete_per_object_latency = mn.value("delete_per_object_latency", cfg.minio.delete_per_object_latency);
+        cfg.minio.delete_batch = mn.value("delete_batch", cfg.minio.delete_batch);
+    }
+
     // Environment variable overrides for Kafka SASL (from dedup-credentials Secret)
     if (const char* v = std::getenv("KAFKA_USER"))
         cfg.metrics_trace.sasl_username = v;
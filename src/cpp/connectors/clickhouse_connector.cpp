@@ -13,10 +13,10 @@
 // TODO: Install ClickHouse in K8s cluster
 
 #include "clickhouse_connector.hpp"
+#include "http_client.hpp"
 #include "../utils/logger.hpp"
 #include "../utils/timer.hpp"
 #include "../utils/sha256.hpp"
-#include <curl/curl.h>
 #include <filesystem>
 #include <fstream>
 #include <sstream>
@@ -24,38 +24,18 @@
 namespace dedup {
 namespace fs = std::filesystem;
 
-static size_t ch_write_cb(char* ptr, size_t size, size_t nmemb, std::string* data) {
-    data->append(ptr, size * nmemb);
-    return size * nmemb;
-}
-
 std::string ClickHouseConnector::http_query(const std::string& sql) {
 #ifdef DEDUP_DRY_RUN
     LOG_DBG("[clickhouse] DRY RUN query: %s", sql.c_str());
     return "0";
 #endif
-    CURL* curl = curl_easy_init();
-    if (!curl) return "";
-
-    std::string url = endpoint_ + "/?database=" + database_;
-    if (!user_.empty()) url += "&user=" + user_;
-    if (!password_.empty()) url += "&password=" + password_;
-    std::string response;
-
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, sql.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, ch_write_cb);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
-
-    CURLcode res = curl_easy_perform(curl);
-    curl_easy_cleanup(curl);
-
-    if (res != CURLE_OK) {
-        LOG_ERR("[clickhouse] HTTP query failed: %s", curl_easy_strerror(res));
+    // Keep-alive: consecutive per-file INSERTs share one connection
+    auto resp = HttpClient::post(endpoint_ + "/?database=" + database_, sql, 30, 0, &auth_headers_);
+    if (resp.curl_code != 0) {
+        LOG_ERR("[clickhouse] HTTP query failed: %s", resp.error().c_str());
         return "";
     }
-    return response;
+    return resp.body;
 }
 
 bool ClickHouseConnector::http_exec(const std::string& sql) {
@@ -69,6 +49,10 @@ bool ClickHouseConnector::connect(const DbConnection& conn) {
     database_ = "default";  // connect to default DB; create_lab_schema() handles target DB
     user_ = conn.user;
     password_ = conn.password;
+    // Credentials as headers, built once for every query
+    auth_headers_ = HttpHeaders{};
+    if (!user_.empty()) auth_headers_.add("X-ClickHouse-User: " + user_);
+    if (!password_.empty()) auth_headers_.add("X-ClickHouse-Key: " + password_);
 
 #ifdef DEDUP_DRY_RUN
     LOG_INF("[clickhouse] DRY RUN: simulating connection to %s", endpoint_.c_str());
@@ -77,23 +61,9 @@ bool ClickHouseConnector::connect(const DbConnection& conn) {
 #endif
 
     // Health check via HTTP ping
-    CURL* curl = curl_easy_init();
-    if (!curl) return false;
-
-    std::string url = endpoint_ + "/ping";
-    std::string response;
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, ch_write_cb);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 10L);
-
-    CURLcode res = curl_easy_perform(curl);
-    long http_code = 0;
-    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-    curl_easy_cleanup(curl);
-
-    if (res != CURLE_OK || http_code != 200) {
-        LOG_ERR("[clickhouse] Health check failed: curl=%d, http=%ld", res, http_code);
+    auto resp = HttpClient::get(endpoint_ + "/ping", 10);
+    if (resp.curl_code != 0 || resp.status != 200) {
+        LOG_ERR("[clickhouse] Health check failed: curl=%d, http=%ld", resp.curl_code, resp.status);
         return false;
     }
 
@@ -4,6 +4,7 @@
 // Uses ClickHouse HTTP API (port 8123) or clickhouse-cpp library
 // TODO: Install ClickHouse in K8s cluster (StatefulSet with Longhorn PVC)
 #include "db_connector.hpp"
+#include "http_client.hpp"
 
 namespace dedup {
 
@@ -43,9 +44,10 @@ private:
     std::string database_;
     std::string user_;        // ClickHouse user (e.g. dedup_lab)
     std::string password_;    // ClickHouse password
+    HttpHeaders auth_headers_;  // X-ClickHouse-User / -Key
     bool connected_ = false;
 
-    // HTTP query helper using libcurl
+    // HTTP query helper (HttpClient keep-alive)
     std::string http_query(const std::string& sql);
     bool http_exec(const std::string& sql);
 };
@@ -12,10 +12,10 @@
 // TODO: Align endpoints with actual comdare-DB REST API once deployed
 
 #include "comdare_connector.hpp"
+#include "http_client.hpp"
 #include "../utils/logger.hpp"
 #include "../utils/timer.hpp"
 #include "../utils/sha256.hpp"
-#include <curl/curl.h>
 #include <nlohmann/json.hpp>
 #include <filesystem>
 #include <fstream>
@@ -23,41 +23,21 @@
 namespace dedup {
 namespace fs = std::filesystem;
 
-static size_t cd_write_cb(char* ptr, size_t size, size_t nmemb, std::string* data) {
-    data->append(ptr, size * nmemb);
-    return size * nmemb;
-}
-
 std::string ComdareConnector::http_get(const std::string& path) {
 #ifdef DEDUP_DRY_RUN
     LOG_DBG("[comdare-db] DRY RUN GET %s", path.c_str());
     return R"({"logical_size_bytes":0})";
 #endif
-    CURL* curl = curl_easy_init();
-    if (!curl) return "";
-
-    std::string url = endpoint_ + path;
-    std::string response;
-
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, cd_write_cb);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
-
-    CURLcode res = curl_easy_perform(curl);
-    long http_code = 0;
-    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-    curl_easy_cleanup(curl);
-
-    if (res != CURLE_OK) {
-        LOG_ERR("[comdare-db] GET %s failed: %s", path.c_str(), curl_easy_strerror(res));
+    auto resp = HttpClient::get(endpoint_ + path, 30);
+    if (resp.curl_code != 0) {
+        LOG_ERR("[comdare-db] GET %s failed: %s", path.c_str(), resp.error().c_str());
         return "";
     }
-    if (http_code >= 400) {
-        LOG_ERR("[comdare-db] GET %s returned HTTP %ld", path.c_str(), http_code);
+    if (resp.status >= 400) {
+        LOG_ERR("[comdare-db] GET %s returned HTTP %ld", path.c_str(), resp.status);
         return "";
     }
-    return response;
+    return resp.body;
 }
 
 std::string ComdareConnector::http_post(const std::string& path, const std::string& body,
@@ -66,39 +46,27 @@ std::string ComdareConnector::http_post(const std::string& path, const std::stri
     LOG_DBG("[comdare-db] DRY RUN POST %s (%zu bytes)", path.c_str(), body.size());
     return "{}";
 #endif
-    CURL* curl = curl_easy_init();
-    if (!curl) return "";
-
-    std::string url = endpoint_ + path;
-    std::string response;
-
-    struct curl_slist* headers = nullptr;
-    headers = curl_slist_append(headers, ("Content-Type: " + content_type).c_str());
-
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body.c_str());
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, static_cast<long>(body.size()));
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, cd_write_cb);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 60L);
-
-    CURLcode res = curl_easy_perform(curl);
-    long http_code = 0;
-    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-    curl_slist_free_all(headers);
-    curl_easy_cleanup(curl);
-
-    if (res != CURLE_OK) {
-        LOG_ERR("[comdare-db] POST %s failed: %s", path.c_str(), curl_easy_strerror(res));
+    HttpHeaders headers{"Content-Type: " + content_type};
+    auto resp = HttpClient::post(endpoint_ + path, body, 60, 0, &headers);
+    if (resp.curl_code != 0) {
+        LOG_ERR("[comdare-db] POST %s failed: %s", path.c_str(), resp.error().c_str());
         return "";
     }
-    if (http_code >= 400) {
+    if (resp.status >= 400) {
         LOG_ERR("[comdare-db] POST %s returned HTTP %ld: %s",
-            path.c_str(), http_code, response.c_str());
+            path.c_str(), resp.status, resp.body.c_str());
         return "";
     }
-    return response;
+    return resp.body;
+}
+
+bool ComdareConnector::http_delete(const std::string& path, long timeout_s) {
+    HttpRequest req;
+    req.method = "DELETE";
+    req.url = endpoint_ + path;
+    req.timeout_s = timeout_s;
+    auto resp = HttpClient::perform(req);
+    return resp.curl_code == 0 && resp.status < 400;
 }
 
 bool ComdareConnector::connect(const DbConnection& conn) {
@@ -144,18 +112,11 @@ bool ComdareConnector::drop_lab_schema(const std::string& schema_name) {
 #ifdef DEDUP_DRY_RUN
     return true;
 #endif
-    // Use DELETE method via custom request
-    CURL* curl = curl_easy_init();
-    if (!curl) return false;
-
-    std::string url = endpoint_ + "/api/v1/databases/" + schema_name;
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "DELETE");
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
-
-    CURLcode res = curl_easy_perform(curl);
-    curl_easy_cleanup(curl);
-    return res == CURLE_OK;
+    // Status not checked: a database that does not exist is dropped too
+    HttpRequest req;
+    req.method = "DELETE";
+    req.url = endpoint_ + "/api/v1/databases/" + schema_name;
+    return HttpClient::perform(req).curl_code == 0;
 }
 
 bool ComdareConnector::reset_lab_schema(const std::string& schema_name) {
@@ -170,38 +131,29 @@ std::string ComdareConnector::http_post_with_metadata(
     LOG_DBG("[comdare-db] DRY RUN POST %s (%zu bytes, file=%s)", path.c_str(), len, filename.c_str());
     return "{}";
 #endif
-    CURL* curl = curl_easy_init();
-    if (!curl) return "";
-
-    std::string url = endpoint_ + path;
-    std::string response;
-
-    struct curl_slist* headers = nullptr;
-    headers = curl_slist_append(headers, "Content-Type: application/octet-stream");
-    headers = curl_slist_append(headers, ("X-Filename: " + filename).c_str());
-    headers = curl_slist_append(headers, ("X-SHA256: " + sha256).c_str());
-    headers = curl_slist_append(headers, ("X-Size-Bytes: " + std::to_string(size_bytes)).c_str());
-    headers = curl_slist_append(headers, "X-MIME: application/octet-stream");
-
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, data);
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, static_cast<long>(len));
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, cd_write_cb);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 60L);
-
-    CURLcode res = curl_easy_perform(curl);
-    long http_code = 0;
-    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-    curl_slist_free_all(headers);
-    curl_easy_cleanup(curl);
-
-    if (res != CURLE_OK || http_code >= 400) {
-        LOG_ERR("[comdare-db] POST %s failed: curl=%d, http=%ld", path.c_str(), res, http_code);
+    HttpHeaders headers{
+        "Content-Type: application/octet-stream",
+        "X-Filename: " + filename,
+        "X-SHA256: " + sha256,
+        "X-Size-Bytes: " + std::to_string(size_bytes),
+        "X-MIME: application/octet-stream",
+        "Expect:",  // no 100-continue round trip in the per-file latency
+    };
+
+    HttpRequest req;
+    req.method = "POST";
+    req.url = endpoint_ + path;
+    req.headers = &headers;
+    req.body = data;
+    req.body_len = len;
+    req.timeout_s = 60;
+    auto resp = HttpClient::perform(req);
+
+    if (resp.curl_code != 0 || resp.status >= 400) {
+        LOG_ERR("[comdare-db] POST %s failed: curl=%d, http=%ld", path.c_str(), resp.curl_code, resp.status);
         return "";
     }
-    return response;
+    return resp.body;
 }
 
 MeasureResult ComdareConnector::bulk_insert(const std::string& data_dir, DupGrade grade) {
@@ -306,15 +258,7 @@ MeasureResult ComdareConnector::perfile_delete() {
     if (list_resp.empty()) {
         // Fallback: bulk delete without per-object latency
         LOG_WRN("[comdare-db] Could not list objects -- falling back to bulk delete");
-        CURL* curl = curl_easy_init();
-        if (curl) {
-            std::string url = endpoint_ + "/api/v1/databases/" + database_ + "/objects";
-            curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-            curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "DELETE");
-            curl_easy_setopt(curl, CURLOPT_TIMEOUT, 120L);
-            curl_easy_perform(curl);
-            curl_easy_cleanup(curl);
-        }
+        http_delete("/api/v1/databases/" + database_ + "/objects", 120);
         total_timer.stop();
         result.duration_ns = total_timer.elapsed_ns();
         return result;
@@ -343,21 +287,8 @@ MeasureResult ComdareConnector::perfile_delete() {
         int64_t del_ns = 0;
         {
             ScopedTimer st(del_ns);
-            CURL* curl = curl_easy_init();
-            if (curl) {
-                std::string url = endpoint_ + "/api/v1/databases/" + database_ + "/objects/" + obj_id;
-                curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-                curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "DELETE");
-                curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
-
-                CURLcode res = curl_easy_perform(curl);
-                long http_code = 0;
-                curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-                curl_easy_cleanup(curl);
-
-                if (res == CURLE_OK && http_code < 400) {
-                    result.rows_affected++;
-                }
+            if (http_delete("/api/v1/databases/" + database_ + "/objects/" + obj_id)) {
+                result.rows_affected++;
             }
         }
         result.per_file_latencies_ns.push_back(del_ns);
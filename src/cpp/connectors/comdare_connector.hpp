@@ -37,10 +37,11 @@ private:
     std::string database_;    // Lab database name
     bool connected_ = false;
 
-    // HTTP helpers using libcurl
+    // HTTP helpers (HttpClient keep-alive)
     std::string http_get(const std::string& path);
     std::string http_post(const std::string& path, const std::string& body,
                           const std::string& content_type = "application/json");
+    bool http_delete(const std::string& path, long timeout_s = 30);  // false on HTTP >= 400
     // POST with metadata headers (X-Filename, X-SHA256, X-Size-Bytes, X-MIME)
     std::string http_post_with_metadata(const std::string& path, const char* data, size_t len,
                                          const std::string& filename, const std::string& sha256,
@@ -0,0 +1,221 @@
+#include "crdb_client.hpp"
+#include "../utils/logger.hpp"
+#include <cstdlib>
+
+namespace dedup {
+
+static constexpr const char* SQLSTATE_SERIALIZATION_FAILURE = "40001";
+
+// Split "host:port" / "[v6]:port" as reported by gossip_nodes
+static bool split_address(const std::string& addr, CrdbGateway& gw) {
+    auto colon = addr.rfind(':');
+    if (colon == std::string::npos || colon == 0) return false;
+    std::string host = addr.substr(0, colon);
+    if (host.size() > 2 && host.front() == '[' && host.back() == ']') {
+        host = host.substr(1, host.size() - 2);
+    }
+    long port = std::strtol(addr.c_str() + colon + 1, nullptr, 10);
+    if (port <= 0 || port > 65535) return false;
+    gw.host = std::move(host);
+    gw.port = static_cast<uint16_t>(port);
+    return true;
+}
+
+std::vector<CrdbGateway> crdb_discover_gateways(PGconn* conn) {
+    std::vector<CrdbGateway> gateways;
+    if (!conn) return gateways;
+
+    // sql_address differs from the RPC address when a separate SQL listener
+    // is configured; older releases only have `address`.
+    PGresult* res = PQexec(conn,
+        "SELECT node_id, sql_address FROM crdb_internal.gossip_nodes "
+        "WHERE is_live ORDER BY node_id");
+    if (PQresultStatus(res) != PGRES_TUPLES_OK) {
+        PQclear(res);
+        res = PQexec(conn,
+            "SELECT node_id, address FROM crdb_internal.gossip_nodes "
+            "WHERE is_live ORDER BY node_id");
+    }
+    if (PQresultStatus(res) != PGRES_TUPLES_OK) {
+        LOG_WRN("[cockroachdb] Gateway discovery failed: %s", PQerrorMessage(conn));
+        PQclear(res);
+        return gateways;
+    }
+
+    for (int i = 0; i < PQntuples(res); ++i) {
+        CrdbGateway gw;
+        gw.node_id = std::strtoll(PQgetvalue(res, i, 0), nullptr, 10);
+        if (split_address(PQgetvalue(res, i, 1), gw)) {
+            gateways.push_back(std::move(gw));
+        }
+    }
+    PQclear(res);
+    return gateways;
+}
+
+// Run a transaction-control statement; on failure returns its SQLSTATE
+static bool control(PGconn* conn, const char* sql, std::string& sqlstate, std::string& error) {
+    PGresult* res = PQexec(conn, sql);
+    bool ok = (PQresultStatus(res) == PGRES_COMMAND_OK);
+    if (!ok) {
+        const char* st = PQresultErrorField(res, PG_DIAG_SQLSTATE);
+        sqlstate = st ? st : "";
+        error = PQresultErrorMessage(res);
+    }
+    PQclear(res);
+    return ok;
+}
+
+bool crdb_retry_txn(PGconn* conn, int max_retries,
+                    const std::function<PGresult*()>& stmt,
+                    int64_t& retries, int64_t& rows, std::string& error) {
+    if (!conn) {
+        error = "no connection";
+        return false;
+    }
+
+    std::string sqlstate;
+    if (!control(conn, "BEGIN", sqlstate, error)) return false;
+    if (!control(conn, "SAVEPOINT cockroach_restart", sqlstate, error)) {
+        control(conn, "ROLLBACK", sqlstate, error);
+        return false;
+    }
+
+    for (int attempt = 0;; ++attempt) {
+        sqlstate.clear();
+
+        PGresult* res = stmt();
+        ExecStatusType st = PQresultStatus(res);
+        bool ok = (st == PGRES_COMMAND_OK || st == PGRES_TUPLES_OK);
+        if (ok) {
+            const char* n = PQcmdTuples(res);
+            rows = (n && n[0]) ? std::strtoll(n, nullptr, 10) : 0;
+        } else {
+            const char* code = PQresultErrorField(res, PG_DIAG_SQLSTATE);
+            sqlstate = code ? code : "";
+            error = PQresultErrorMessage(res);
+        }
+        PQclear(res);
+
+        if (ok) ok = control(conn, "RELEASE SAVEPOINT cockroach_restart", sqlstate, error);
+        if (ok) {
+            std::string ignored;
+            if (control(conn, "COMMIT", ignored, error)) {
+                error.clear();
+                return true;
+            }
+            return false;
+        }
+
+        if (sqlstate != SQLSTATE_SERIALIZATION_FAILURE || attempt >= max_retries) break;
+
+        ++retries;
+        LOG_DBG("[cockroachdb] 40001 retry %d: %s", attempt + 1, error.c_str());
+        std::string rb_state, rb_error;
+        if (!control(conn, "ROLLBACK TO SAVEPOINT cockroach_restart", rb_state, rb_error)) {
+            error = rb_error;
+            break;
+        }
+    }
+
+    std::string ignored_state, ignored_error;
+    control(conn, "ROLLBACK", ignored_state, ignored_error);
+    if (sqlstate == SQLSTATE_SERIALIZATION_FAILURE) {
+        error = "retry limit reached: " + error;
+    }
+    return false;
+}
+
+// --- Size provider ---
+
+const char* CrdbSizeProvider::method_name(Method m) {
+    switch (m) {
+        case Method::SPAN_STATS:   return "tenant_span_stats";
+        case Method::SHOW_RANGES:  return "SHOW RANGES WITH DETAILS";
+        case Method::RANGES_TABLE: return "crdb_internal.ranges";
+        case Method::UNKNOWN:      break;
+    }
+    return "none";
+}
+
+// Single int8 from a one-row query; false on error
+static bool query_int64(PGconn* conn, const std::string& sql, int64_t& out) {
+    PGresult* res = PQexec(conn, sql.c_str());
+    bool ok = (PQresultStatus(res) == PGRES_TUPLES_OK);
+    if (ok) {
+        out = 0;
+        if (PQntuples(res) > 0 && !PQgetisnull(res, 0, 0)) {
+            out = std::strtoll(PQgetvalue(res, 0, 0), nullptr, 10);
+        }
+    } else {
+        LOG_DBG("[cockroachdb] %s: %s", sql.c_str(), PQresultErrorMessage(res));
+    }
+    PQclear(res);
+    return ok;
+}
+
+bool CrdbSizeProvider::measure(PGconn* conn, Method m, int64_t& bytes) {
+    switch (m) {
+        case Method::SPAN_STATS: {
+            // Span stats are served from range MVCC stats of the database's
+            // own spans -- no cluster-wide range descriptor scan.
+            if (database_id_ < 0) {
+                if (!query_int64(conn, "SELECT id FROM crdb_internal.databases WHERE name = '" +
+                                 database_ + "'", database_id_) || database_id_ <= 0) {
+                    database_id_ = -1;
+                    return false;
+                }
+            }
+            return query_int64(conn,
+                "SELECT COALESCE(sum(total_bytes), 0)::INT8 FROM crdb_internal.tenant_span_stats(" +
+                std::to_string(database_id_) + ")", bytes);
+        }
+        case Method::SHOW_RANGES:
+            return query_int64(conn,
+                "SELECT COALESCE(sum(range_size), 0)::INT8 FROM [SHOW RANGES FROM DATABASE " +
+                database_ + " WITH DETAILS]", bytes);
+        case Method::RANGES_TABLE:
+            return query_int64(conn,
+                "SELECT COALESCE(sum(range_size), 0)::INT8 FROM crdb_internal.ranges "
+                "WHERE database_name = '" + database_ + "'", bytes);
+        case Method::UNKNOWN:
+            break;
+    }
+    return false;
+}
+
+int64_t CrdbSizeProvider::database_bytes(PGconn* conn, const std::string& database) {
+    if (database != database_) {
+        database_ = database;
+        database_id_ = -1;
+        cached_ = -1;
+        fresh_ = false;
+    }
+    if (fresh_) return cached_;
+    if (!conn) return cached_;
+
+    int64_t bytes = 0;
+    if (method_ != Method::UNKNOWN && measure(conn, method_, bytes)) {
+        cached_ = bytes;
+        fresh_ = true;
+        return cached_;
+    }
+
+    // Probe cheapest first; remember the first method this server supports
+    for (Method m : {Method::SPAN_STATS, Method::SHOW_RANGES, Method::RANGES_TABLE}) {
+        if (m == method_) continue;
+        if (measure(conn, m, bytes)) {
+            LOG_INF("[cockroachdb] Logical size via %s", method_name(m));
+            method_ = m;
+            cached_ = bytes;
+            fresh_ = true;
+            return cached_;
+        }
+    }
+
+    LOG_WRN("[cockroachdb] Size measurement failed -- using cached value %lld",
+        static_cast<long long>(cached_));
+    return cached_;
+}
+
+} // namespace dedup
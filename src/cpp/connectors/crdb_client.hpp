@@ -0,0 +1,68 @@
+#pragma once
+// CockroachDB client-side helpers for PostgresConnector (COCKROACHDB mode)
+//
+// Gateway discovery: every live node from crdb_internal.gossip_nodes, so
+// parallel workers can connect to different SQL gateways instead of all
+// landing on whichever node the public service picks.
+//
+// Retry protocol (CockroachDB docs, "Transaction Retry Error Reference"):
+//   BEGIN; SAVEPOINT cockroach_restart;
+//   <statement>            -- on SQLSTATE 40001: ROLLBACK TO SAVEPOINT, retry
+//   RELEASE SAVEPOINT cockroach_restart;   -- may also fail with 40001
+//   COMMIT;
+// Retries become visible to the client and are counted per stage.
+//
+// Size provider: logical bytes of one database from span statistics
+// (crdb_internal.tenant_span_stats, v23.1+) or SHOW RANGES ... WITH DETAILS
+// scoped to that database, instead of materialising the cluster-wide
+// crdb_internal.ranges table. The value is cached until invalidate().
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include <libpq-fe.h>
+
+namespace dedup {
+
+struct CrdbGateway {
+    int64_t node_id = 0;
+    std::string host;
+    uint16_t port = 26257;
+};
+
+// Live nodes ordered by node_id (SQL address). Empty if the query fails.
+std::vector<CrdbGateway> crdb_discover_gateways(PGconn* conn);
+
+// Run `stmt` (returns a PGresult the helper clears) in one explicit
+// transaction with the cockroach_restart retry loop. `retries` is
+// incremented for every 40001 retry; `rows` receives CmdTuples of the
+// successful attempt. Returns false on a non-retryable error or when
+// max_retries is exhausted (transaction rolled back, message in `error`).
+bool crdb_retry_txn(PGconn* conn, int max_retries,
+                    const std::function<PGresult*()>& stmt,
+                    int64_t& retries, int64_t& rows, std::string& error);
+
+class CrdbSizeProvider {
+public:
+    // Logical (MVCC total) bytes of `database`. Returns the cached value when
+    // nothing changed since the last measurement, or when every method fails
+    // (-1 if there never was a successful measurement).
+    int64_t database_bytes(PGconn* conn, const std::string& database);
+
+    // Call before anything that may change the database contents
+    void invalidate() { fresh_ = false; }
+
+private:
+    enum class Method { UNKNOWN, SPAN_STATS, SHOW_RANGES, RANGES_TABLE };
+
+    Method method_ = Method::UNKNOWN;  // first method that worked, reused
+    std::string database_;
+    int64_t database_id_ = -1;
+    int64_t cached_ = -1;
+    bool fresh_ = false;
+
+    bool measure(PGconn* conn, Method m, int64_t& bytes);
+    static const char* method_name(Method m);
+};
+
+} // namespace dedup
@@ -29,6 +29,19 @@ struct MeasureResult {
 
     // Per-file latency tracking for histogram analysis (doku.tex Stage 2/3)
     std::vector<int64_t> per_file_latencies_ns;
+
+    // Client-side share of each per-file latency where the connector can
+    // split it off (Kafka: producev + poll vs. broker ack); usually empty
+    std::vector<int64_t> enqueue_latencies_ns;
+
+    // Wall time of each parallel worker (empty for single-connection runs)
+    std::vector<int64_t> worker_durations_ns;
+
+    // Maintenance time of each table partition (partitioned layouts only)
+    std::vector<int64_t> partition_durations_ns;
+
+    // Client-visible transaction retries (CockroachDB 40001)
+    int64_t txn_retries = 0;
 };
 
 // Abstract database connector interface
@@ -117,6 +130,25 @@ public:
         return get_logical_size_bytes();
     }
 
+    // ========================================================================
+    // Configuration variants (schema layout, representation, client profile)
+    // An extra experiment dimension: the run loop repeats every payload type
+    // once per variant and tags each ExperimentResult with its name.
+    // ========================================================================
+
+    // Names of the configured variants (empty = connector has none)
+    [[nodiscard]] virtual std::vector<std::string> variants() const { return {}; }
+
+    // Variants of the native run loop (e.g. Redis record encodings that only
+    // exist in native mode); defaults to variants()
+    [[nodiscard]] virtual std::vector<std::string> native_variants() const { return variants(); }
+
+    // Switch variant before the lab schema is (re)created; "" = default
+    virtual bool select_variant(const std::string& name) { return name.empty(); }
+
+    // Variant in effect, recorded as ExperimentResult::variant
+    [[nodiscard]] virtual std::string current_variant() const { return ""; }
+
     // Connection resilience: reconnect after connection loss.
     // Default: disconnect + connect. Override for protocol-specific reset (e.g. PQreset).
     virtual bool reconnect(const DbConnection& conn) {
@@ -0,0 +1,174 @@
+#include "http_client.hpp"
+#include <curl/curl.h>
+#include <mutex>
+#include <vector>
+
+namespace dedup {
+
+namespace {
+
+// Idle handles kept per thread; more are cleaned up on return
+constexpr size_t POOL_MAX = 32;
+
+// Per-thread handle pool and CURLSH (DNS, connection cache, TLS sessions).
+// Per thread because libcurl does not support sharing one connection cache
+// between concurrently running threads; no lock callbacks are needed then.
+struct Pool {
+    CURLSH* share = nullptr;
+    std::vector<CURL*> idle;
+
+    Pool() {
+        static std::once_flag global;
+        std::call_once(global, [] { curl_global_init(CURL_GLOBAL_DEFAULT); });
+        share = curl_share_init();
+        curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+        curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    }
+    ~Pool() {
+        for (CURL* c : idle) curl_easy_cleanup(c);
+        if (share) curl_share_cleanup(share);  // after its last user
+    }
+};
+
+thread_local Pool pool;
+
+size_t write_cb(char* ptr, size_t size, size_t nmemb, void* userdata) {
+    static_cast<std::string*>(userdata)->append(ptr, size * nmemb);
+    return size * nmemb;
+}
+
+} // namespace
+
+// --- HttpHeaders ---
+
+HttpHeaders::~HttpHeaders() {
+    if (list_) curl_slist_free_all(list_);
+}
+
+HttpHeaders& HttpHeaders::operator=(HttpHeaders&& o) noexcept {
+    if (this != &o) {
+        if (list_) curl_slist_free_all(list_);
+        list_ = o.list_;
+        o.list_ = nullptr;
+    }
+    return *this;
+}
+
+HttpHeaders& HttpHeaders::add(const std::string& line) {
+    list_ = curl_slist_append(list_, line.c_str());
+    return *this;
+}
+
+std::string HttpResponse::error() const {
+    if (curl_code != 0) return curl_easy_strerror(static_cast<CURLcode>(curl_code));
+    return "HTTP " + std::to_string(status);
+}
+
+// --- Handle pool ---
+
+HttpClient::Handle::Handle() {
+    if (!pool.idle.empty()) {
+        curl_ = pool.idle.back();
+        pool.idle.pop_back();
+        return;
+    }
+    curl_ = curl_easy_init();
+}
+
+HttpClient::Handle::~Handle() {
+    if (!curl_) return;
+    if (pool.idle.size() >= POOL_MAX) {
+        curl_easy_cleanup(curl_);
+        return;
+    }
+    // Clears options only; the shared caches keep the connections
+    curl_easy_reset(curl_);
+    pool.idle.push_back(curl_);
+}
+
+// --- Requests ---
+
+void HttpClient::prepare(CURL* curl, const HttpRequest& req, HttpResponse& resp) {
+    curl_easy_setopt(curl, CURLOPT_SHARE, pool.share);
+    curl_easy_setopt(curl, CURLOPT_URL, req.url.c_str());
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, req.timeout_s);
+    if (req.connect_timeout_s > 0)
+        curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, req.connect_timeout_s);
+    if (req.headers) curl_easy_setopt(curl, CURLOPT_HTTPHEADER, req.headers->get());
+
+    if (req.method == "HEAD") {
+        curl_easy_setopt(curl, CURLOPT_NOBODY, 1L);
+    } else if (req.body || req.method == "POST") {
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, req.body ? req.body : "");
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(req.body_len));
+        if (req.method != "POST") curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, req.method.c_str());
+    } else if (req.method != "GET") {
+        curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, req.method.c_str());
+    }
+
+    resp.body.clear();
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_cb);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &resp.body);
+}
+
+void HttpClient::complete(CURL* curl, int code, HttpResponse& resp) {
+    resp.curl_code = code;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &resp.status);
+
+    curl_off_t t = -1;
+    curl_easy_getinfo(curl, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &t);
+    resp.content_length = t;
+    t = 0;
+    curl_easy_getinfo(curl, CURLINFO_NAMELOOKUP_TIME_T, &t);
+    resp.timing.namelookup_us = t;
+    curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME_T, &t);
+    resp.timing.connect_us = t;
+    curl_easy_getinfo(curl, CURLINFO_PRETRANSFER_TIME_T, &t);
+    resp.timing.pretransfer_us = t;
+    curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME_T, &t);
+    resp.timing.starttransfer_us = t;
+    curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME_T, &t);
+    resp.timing.total_us = t;
+    long connects = 0;
+    curl_easy_getinfo(curl, CURLINFO_NUM_CONNECTS, &connects);
+    resp.timing.reused = code == CURLE_OK && connects == 0;
+}
+
+HttpResponse HttpClient::perform(const HttpRequest& req) {
+    HttpResponse resp;
+    Handle h;
+    if (!h) {
+        resp.curl_code = CURLE_FAILED_INIT;
+        return resp;
+    }
+    prepare(h.get(), req, resp);
+    complete(h.get(), curl_easy_perform(h.get()), resp);
+    return resp;
+}
+
+HttpResponse HttpClient::get(const std::string& url, long timeout_s, long connect_timeout_s) {
+    HttpRequest req;
+    req.url = url;
+    req.timeout_s = timeout_s;
+    req.connect_timeout_s = connect_timeout_s;
+    return perform(req);
+}
+
+HttpResponse HttpClient::post(const std::string& url, const std::string& body,
+                              long timeout_s, long connect_timeout_s,
+                              const HttpHeaders* headers) {
+    HttpRequest req;
+    req.method = "POST";
+    req.url = url;
+    req.headers = headers;
+    req.body = body.data();
+    req.body_len = body.size();
+    req.timeout_s = timeout_s;
+    req.connect_timeout_s = connect_timeout_s;
+    return perform(req);
+}
+
+} // namespace dedup
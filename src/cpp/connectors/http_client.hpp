@@ -0,0 +1,121 @@
+#pragma once
+// Shared keep-alive HTTP client for all libcurl users
+//
+// Easy handles are pooled per thread and reset (not destroyed) between
+// requests; all handles of a thread are attached to the thread's CURLSH,
+// which shares the DNS cache, the connection cache and TLS sessions. A
+// request therefore reuses an idle keep-alive connection to the same host,
+// whichever call site opened it -- per-request latency no longer includes
+// TCP setup except for the first request (or after the server closed it).
+// (One share per thread: libcurl cannot share a connection cache between
+// concurrently running threads.)
+//
+// Fixed header sets (content type, auth) are built once as HttpHeaders and
+// referenced by every request. HttpResponse::timing carries libcurl's own
+// phase timestamps, so callers can tell connection setup from server time.
+//
+// Upload bodies are referenced, not copied: keep them alive until perform()
+// returns. Callers that drive handles themselves (curl_multi) use acquire() /
+// prepare() / complete() instead of perform().
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+
+typedef void CURL;
+struct curl_slist;
+
+namespace dedup {
+
+// Move-only curl_slist of "Name: value" lines
+class HttpHeaders {
+public:
+    HttpHeaders() = default;
+    HttpHeaders(std::initializer_list<std::string> lines) {
+        for (const auto& l : lines) add(l);
+    }
+    ~HttpHeaders();
+
+    HttpHeaders(HttpHeaders&& o) noexcept : list_(o.list_) { o.list_ = nullptr; }
+    HttpHeaders& operator=(HttpHeaders&& o) noexcept;
+    HttpHeaders(const HttpHeaders&) = delete;
+    HttpHeaders& operator=(const HttpHeaders&) = delete;
+
+    HttpHeaders& add(const std::string& line);
+    [[nodiscard]] curl_slist* get() const { return list_; }
+
+private:
+    curl_slist* list_ = nullptr;
+};
+
+// libcurl phase times of one transfer (CURLINFO_*_TIME_T), microseconds
+// from the start of the request
+struct HttpTiming {
+    int64_t namelookup_us = 0;
+    int64_t connect_us = 0;        // TCP established (0 on a reused connection)
+    int64_t pretransfer_us = 0;    // request about to be sent
+    int64_t starttransfer_us = 0;  // first response byte (TTFB)
+    int64_t total_us = 0;
+    bool reused = false;           // no new connection was opened
+};
+
+struct HttpRequest {
+    std::string method = "GET";    // HEAD = no response body
+    std::string url;
+    const HttpHeaders* headers = nullptr;  // not owned
+    const char* body = nullptr;    // not copied
+    size_t body_len = 0;
+    long timeout_s = 30;
+    long connect_timeout_s = 0;    // 0 = libcurl default
+};
+
+struct HttpResponse {
+    int curl_code = 0;             // CURLcode
+    long status = 0;               // HTTP status, 0 if no response
+    int64_t content_length = -1;   // Content-Length header (also for HEAD), -1 if none
+    std::string body;
+    HttpTiming timing;
+
+    [[nodiscard]] bool ok() const { return curl_code == 0 && status >= 200 && status < 300; }
+    // curl error text, else "HTTP <status>"
+    [[nodiscard]] std::string error() const;
+};
+
+class HttpClient {
+public:
+    // Pooled easy handle of the calling thread; returned (reset) on
+    // destruction, so it must not outlive or change threads
+    class Handle {
+    public:
+        Handle();
+        ~Handle();
+        Handle(Handle&& o) noexcept : curl_(o.curl_) { o.curl_ = nullptr; }
+        Handle& operator=(Handle&&) = delete;
+        Handle(const Handle&) = delete;
+        Handle& operator=(const Handle&) = delete;
+
+        [[nodiscard]] CURL* get() const { return curl_; }
+        explicit operator bool() const { return curl_ != nullptr; }
+
+    private:
+        CURL* curl_;
+    };
+
+    // One blocking request on a pooled handle
+    static HttpResponse perform(const HttpRequest& req);
+
+    static HttpResponse get(const std::string& url, long timeout_s = 30,
+                            long connect_timeout_s = 0);
+    static HttpResponse post(const std::string& url, const std::string& body,
+                             long timeout_s = 30, long connect_timeout_s = 0,
+                             const HttpHeaders* headers = nullptr);
+
+    static Handle acquire() { return Handle(); }
+    // Set all options of `req` on `curl`; the response body goes to resp.body
+    // (resp must stay at its address until the transfer is done)
+    static void prepare(CURL* curl, const HttpRequest& req, HttpResponse& resp);
+    // Fill status and timing after the transfer finished with `code`
+    static void complete(CURL* curl, int code, HttpResponse& resp);
+};
+
+} // namespace dedup
@@ -1,8 +1,14 @@
 #include "kafka_connector.hpp"
+#include "kafka_delivery.hpp"
+#include "http_client.hpp"
 #include "../utils/logger.hpp"
+#include "../utils/sha256.hpp"
 #include "../utils/timer.hpp"
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
+#include <sstream>
+#include <thread>
 
 #ifdef HAS_RDKAFKA
 #include <librdkafka/rdkafka.h>
@@ -21,16 +27,59 @@ bool KafkaConnector::connect(const DbConnection& conn) {
     return true;
 #endif
 
+#ifdef HAS_RDKAFKA
+    conn_ = conn;
+    if (!create_producer()) return false;
+    {
+        std::string user = conn.user, pass = conn.password;
+        if (const char* v = std::getenv("KAFKA_USER")) user = v;
+        if (const char* v = std::getenv("KAFKA_PASSWORD")) pass = v;
+        log_dirs_ = std::make_unique<KafkaLogDirs>(conn.host, conn.port, user, pass);
+    }
+    connected_ = true;
+    LOG_INF("[kafka] Connected to %s, topic prefix: %s-*", bootstrap_.c_str(), topic_prefix_.c_str());
+    return true;
+#else
+    LOG_ERR("[kafka] librdkafka not available, Kafka connector disabled");
+    (void)conn;
+    return false;
+#endif
+}
+
+bool KafkaConnector::create_producer() {
 #ifdef HAS_RDKAFKA
     char errstr[512];
     rd_kafka_conf_t* conf = rd_kafka_conf_new();
     rd_kafka_conf_set(conf, "bootstrap.servers", bootstrap_.c_str(), errstr, sizeof(errstr));
     rd_kafka_conf_set(conf, "client.id", "dedup-test", errstr, sizeof(errstr));
 
+    // Selected producer profile on top of the KafkaTuning defaults
+    std::string acks = tuning_.acks;
+    std::vector<std::pair<std::string, std::string>> settings;
+    if (profile_) {
+        if (!profile_->acks.empty()) acks = profile_->acks;
+        if (!profile_->compression.empty())
+            settings.emplace_back("compression.type", profile_->compression);
+        if (profile_->linger_ms >= 0)
+            settings.emplace_back("linger.ms", std::to_string(profile_->linger_ms));
+        if (profile_->batch_size > 0)
+            settings.emplace_back("batch.size", std::to_string(profile_->batch_size));
+    }
+    settings.emplace_back("acks", acks);
+    for (const auto& [key, value] : settings) {
+        if (rd_kafka_conf_set(conf, key.c_str(), value.c_str(), errstr, sizeof(errstr)) != RD_KAFKA_CONF_OK) {
+            LOG_ERR("[kafka] Invalid %s '%s': %s", key.c_str(), value.c_str(), errstr);
+            rd_kafka_conf_destroy(conf);
+            return false;
+        }
+    }
+    // Delivery reports carry the per-message opaque of KafkaDelivery
+    rd_kafka_conf_set_dr_msg_cb(conf, KafkaDelivery::on_delivery);
+
     // SASL/SCRAM-SHA-512 auth (dedup-lab KafkaUser via Strimzi)
     // Credentials from env KAFKA_USER/KAFKA_PASSWORD or DbConnection user/password
-    std::string sasl_user = conn.user;
-    std::string sasl_pass = conn.password;
+    std::string sasl_user = conn_.user;
+    std::string sasl_pass = conn_.password;
     if (const char* v = std::getenv("KAFKA_USER")) sasl_user = v;
     if (const char* v = std::getenv("KAFKA_PASSWORD")) sasl_pass = v;
 
@@ -39,7 +88,7 @@ bool KafkaConnector::connect(const DbConnection& conn) {
         rd_kafka_conf_set(conf, "sasl.mechanism", "SCRAM-SHA-512", errstr, sizeof(errstr));
         rd_kafka_conf_set(conf, "sasl.username", sasl_user.c_str(), errstr, sizeof(errstr));
         rd_kafka_conf_set(conf, "sasl.password", sasl_pass.c_str(), errstr, sizeof(errstr));
-        LOG_INF("[kafka] SASL/SCRAM-SHA-512 auth enabled (user=%s)", sasl_user.c_str());
+        LOG_DBG("[kafka] SASL/SCRAM-SHA-512 auth enabled (user=%s)", sasl_user.c_str());
     }
 
     rd_kafka_t* rk = rd_kafka_new(RD_KAFKA_PRODUCER, conf, errstr, sizeof(errstr));
@@ -48,17 +97,18 @@ bool KafkaConnector::connect(const DbConnection& conn) {
         return false;
     }
     producer_ = rk;
-    connected_ = true;
-    LOG_INF("[kafka] Connected to %s, topic prefix: %s-*", bootstrap_.c_str(), topic_prefix_.c_str());
+
+    std::string desc;
+    for (const auto& [key, value] : settings) desc += " " + key + "=" + value;
+    LOG_INF("[kafka] Producer profile %s:%s",
+        profile_ ? profile_->label().c_str() : "default", desc.c_str());
     return true;
 #else
-    LOG_ERR("[kafka] librdkafka not available, Kafka connector disabled");
-    (void)conn;
     return false;
 #endif
 }
 
-void KafkaConnector::disconnect() {
+void KafkaConnector::destroy_producer() {
 #ifdef HAS_RDKAFKA
     if (producer_) {
         auto* rk = static_cast<rd_kafka_t*>(producer_);
@@ -67,30 +117,89 @@ void KafkaConnector::disconnect() {
         producer_ = nullptr;
     }
 #endif
+}
+
+// --- Producer-profile variants ---
+
+std::vector<std::string> KafkaConnector::variants() const {
+    std::vector<std::string> names;
+    for (const auto& p : tuning_.producer_profiles) names.push_back(p.label());
+    return names;
+}
+
+bool KafkaConnector::select_variant(const std::string& name) {
+    const KafkaProducerProfile* next = nullptr;
+    if (!name.empty()) {
+        for (const auto& p : tuning_.producer_profiles) {
+            if (p.label() == name) {
+                next = &p;
+                break;
+            }
+        }
+        if (!next) {
+            LOG_ERR("[kafka] Unknown producer profile %s", name.c_str());
+            return false;
+        }
+        static const char* const CODECS[] = {"", "none", "gzip", "snappy", "lz4", "zstd"};
+        bool codec_ok = false;
+        for (const char* c : CODECS) codec_ok |= (next->compression == c);
+        if (!codec_ok) {
+            LOG_ERR("[kafka] Invalid compression %s in producer profile %s",
+                next->compression.c_str(), name.c_str());
+            return false;
+        }
+    }
+    if (next == profile_) return true;
+
+    profile_ = next;
+    if (!producer_) return true;  // applied by connect()
+    // Producer settings are fixed at rd_kafka_new(): start a fresh producer
+    destroy_producer();
+    return create_producer();
+}
+
+void KafkaConnector::disconnect() {
+    destroy_producer();
+    log_dirs_.reset();
     connected_ = false;
 }
 
 bool KafkaConnector::is_connected() const { return connected_; }
 
-bool KafkaConnector::create_lab_schema(const std::string&) {
-#ifdef DEDUP_DRY_RUN
-    LOG_INF("[kafka] DRY RUN: would create topics %s-U0, %s-U50, %s-U90",
-        topic_prefix_.c_str(), topic_prefix_.c_str(), topic_prefix_.c_str());
-    return true;
-#endif
+std::vector<std::string> KafkaConnector::lab_topics() const {
+    std::vector<std::string> names;
+    for (const char* suffix : {"U0", "U50", "U90"}) names.push_back(topic_prefix_ + "-" + suffix);
+    return names;
+}
 
+bool KafkaConnector::create_topics(const std::vector<std::string>& names) {
 #ifdef HAS_RDKAFKA
     if (!producer_) return false;
     auto* rk = static_cast<rd_kafka_t*>(producer_);
 
     // Create topics via AdminClient API
-    const char* suffixes[] = {"U0", "U50", "U90"};
-    for (const auto& suffix : suffixes) {
-        std::string topic_name = topic_prefix_ + "-" + suffix;
-
+    for (const auto& topic_name : names) {
         rd_kafka_NewTopic_t* new_topic = rd_kafka_NewTopic_new(
             topic_name.c_str(), 4, 3, nullptr, 0);  // 4 partitions, RF=3
 
+        if (tuning_.compacted_topics) {
+            // Log compaction as the dedup path: the newest record per key
+            // (payload SHA-256) survives. "delete" stays in the policy so
+            // DeleteRecords is accepted, with retention disabled. Segments
+            // roll after compaction_segment_ms so the cleaner can reach them.
+            const std::string segment_ms = std::to_string(tuning_.compaction_segment_ms);
+            const std::pair<const char*, const char*> topic_config[] = {
+                {"cleanup.policy", "compact,delete"},
+                {"retention.ms", "-1"},
+                {"retention.bytes", "-1"},
+                {"min.cleanable.dirty.ratio", "0.01"},
+                {"min.compaction.lag.ms", "0"},
+                {"segment.ms", segment_ms.c_str()},
+            };
+            for (const auto& [key, value] : topic_config)
+                rd_kafka_NewTopic_set_config(new_topic, key, value);
+        }
+
         rd_kafka_NewTopic_t* topics[] = {new_topic};
 
         rd_kafka_AdminOptions_t* options = rd_kafka_AdminOptions_new(rk, RD_KAFKA_ADMIN_OP_CREATETOPICS);
@@ -108,7 +217,8 @@ bool KafkaConnector::create_lab_schema(const std::string&) {
                 for (size_t i = 0; i < cnt; i++) {
                     rd_kafka_resp_err_t err = rd_kafka_topic_result_error(res_topics[i]);
                     if (err == RD_KAFKA_RESP_ERR_NO_ERROR || err == RD_KAFKA_RESP_ERR_TOPIC_ALREADY_EXISTS) {
-                        LOG_INF("[kafka] Topic created: %s", rd_kafka_topic_result_name(res_topics[i]));
+                        LOG_INF("[kafka] Topic created: %s%s", rd_kafka_topic_result_name(res_topics[i]),
+                            tuning_.compacted_topics ? " (compacted)" : "");
                     } else {
                         LOG_ERR("[kafka] Topic create failed: %s -- %s",
                             rd_kafka_topic_result_name(res_topics[i]),
@@ -123,31 +233,19 @@ bool KafkaConnector::create_lab_schema(const std::string&) {
         rd_kafka_AdminOptions_destroy(options);
         rd_kafka_NewTopic_destroy(new_topic);
     }
-
-    LOG_INF("[kafka] Lab topics created: %s-{U0,U50,U90}", topic_prefix_.c_str());
     return true;
 #else
-    LOG_INF("[kafka] Lab topics: %s-U0, %s-U50, %s-U90 (auto-create on produce)",
-        topic_prefix_.c_str(), topic_prefix_.c_str(), topic_prefix_.c_str());
+    (void)names;
     return true;
 #endif
 }
 
-bool KafkaConnector::drop_lab_schema(const std::string&) {
-#ifdef DEDUP_DRY_RUN
-    LOG_WRN("[kafka] DRY RUN: would delete topics %s-U0, %s-U50, %s-U90",
-        topic_prefix_.c_str(), topic_prefix_.c_str(), topic_prefix_.c_str());
-    return true;
-#endif
-
+bool KafkaConnector::delete_topics(const std::vector<std::string>& names) {
 #ifdef HAS_RDKAFKA
     if (!producer_) return false;
     auto* rk = static_cast<rd_kafka_t*>(producer_);
 
-    const char* suffixes[] = {"U0", "U50", "U90"};
-    for (const auto& suffix : suffixes) {
-        std::string topic_name = topic_prefix_ + "-" + suffix;
-
+    for (const auto& topic_name : names) {
         rd_kafka_DeleteTopic_t* del_topic = rd_kafka_DeleteTopic_new(topic_name.c_str());
         rd_kafka_DeleteTopic_t* topics[] = {del_topic};
 
@@ -181,7 +279,41 @@ bool KafkaConnector::drop_lab_schema(const std::string&) {
         rd_kafka_AdminOptions_destroy(options);
         rd_kafka_DeleteTopic_destroy(del_topic);
     }
+    return true;
+#else
+    (void)names;
+    return true;
+#endif
+}
+
+bool KafkaConnector::create_lab_schema(const std::string&) {
+#ifdef DEDUP_DRY_RUN
+    LOG_INF("[kafka] DRY RUN: would create topics %s-U0, %s-U50, %s-U90",
+        topic_prefix_.c_str(), topic_prefix_.c_str(), topic_prefix_.c_str());
+    return true;
+#endif
+
+#ifdef HAS_RDKAFKA
+    if (!create_topics(lab_topics())) return false;
+    LOG_INF("[kafka] Lab topics created: %s-{U0,U50,U90}", topic_prefix_.c_str());
+    return true;
+#else
+    LOG_INF("[kafka] Lab topics: %s-U0, %s-U50, %s-U90 (auto-create on produce)",
+        topic_prefix_.c_str(), topic_prefix_.c_str(), topic_prefix_.c_str());
+    return true;
+#endif
+}
 
+bool KafkaConnector::drop_lab_schema(const std::string&) {
+#ifdef DEDUP_DRY_RUN
+    LOG_WRN("[kafka] DRY RUN: would delete topics %s-U0, %s-U50, %s-U90",
+        topic_prefix_.c_str(), topic_prefix_.c_str(), topic_prefix_.c_str());
+    return true;
+#endif
+
+#ifdef HAS_RDKAFKA
+    produced_topics_.clear();
+    if (!delete_topics(lab_topics())) return false;
     LOG_WRN("[kafka] Lab topics deleted: %s-{U0,U50,U90}", topic_prefix_.c_str());
     return true;
 #else
@@ -212,27 +344,12 @@ MeasureResult KafkaConnector::bulk_insert(const std::string& data_dir, DupGrade
     timer.start();
     auto* rk = static_cast<rd_kafka_t*>(producer_);
 
-    for (const auto& entry : fs::directory_iterator(dir)) {
-        if (!entry.is_regular_file()) continue;
-        auto fsize = entry.file_size();
-        std::ifstream f(entry.path(), std::ios::binary);
-        std::vector<char> buf(fsize);
-        f.read(buf.data(), static_cast<std::streamsize>(fsize));
-
-        std::string key = entry.path().filename().string();
-        int err = rd_kafka_producev(rk,
-            RD_KAFKA_V_TOPIC(topic.c_str()),
-            RD_KAFKA_V_KEY(key.data(), key.size()),
-            RD_KAFKA_V_VALUE(buf.data(), fsize),
-            RD_KAFKA_V_MSGFLAGS(RD_KAFKA_MSG_F_COPY),
-            RD_KAFKA_V_END);
-
-        if (err == 0) result.rows_affected++;
-        result.bytes_logical += fsize;
-        rd_kafka_poll(rk, 0);
-    }
-
-    rd_kafka_flush(rk, 30000);
+    // rows_affected = acknowledged messages, counted at finish()
+    KafkaDelivery delivery(rk, result, false, false, tuning_.flush_timeout_ms,
+                           tuning_.max_inflight_bytes);
+    produce_files(dir, topic, delivery, result);
+    delivery.finish();
+    last_produce_ = std::chrono::steady_clock::now();
     timer.stop();
     result.duration_ns = timer.elapsed_ns();
     LOG_INF("[kafka] Bulk produce: %lld msgs, %lld bytes, %lld ms",
@@ -259,53 +376,282 @@ MeasureResult KafkaConnector::perfile_insert(const std::string& data_dir, DupGra
     total_timer.start();
     auto* rk = static_cast<rd_kafka_t*>(producer_);
 
+    // Per-file latency = producev() -> delivery report (broker ack)
+    KafkaDelivery delivery(rk, result, true, tuning_.latency_breakdown, tuning_.flush_timeout_ms,
+                           tuning_.max_inflight_bytes);
+    produce_files(dir, topic, delivery, result);
+    delivery.finish();
+    last_produce_ = std::chrono::steady_clock::now();
+    total_timer.stop();
+    result.duration_ns = total_timer.elapsed_ns();
+    LOG_INF("[kafka] Per-file produce: %lld msgs, %lld bytes, %lld ms",
+        result.rows_affected, result.bytes_logical, total_timer.elapsed_ms());
+#endif
+    return result;
+}
+
+void KafkaConnector::produce_files(const std::string& dir, const std::string& topic,
+                                   KafkaDelivery& delivery, MeasureResult& result) {
+#ifdef HAS_RDKAFKA
+    // Compacted topics: keyed by payload SHA-256, so compaction keeps one
+    // copy per distinct payload
+    produced_topics_.insert(topic);
     for (const auto& entry : fs::directory_iterator(dir)) {
         if (!entry.is_regular_file()) continue;
+        std::string key = entry.path().filename().string();
+
+        if (tuning_.zero_copy) {
+            MappedFile file(entry.path().string());
+            if (!file.ok()) {
+                LOG_ERR("[kafka] Cannot map %s", entry.path().c_str());
+                continue;
+            }
+            const auto fsize = static_cast<int64_t>(file.size());
+            if (tuning_.compacted_topics) key = SHA256::hash_hex(file.data(), file.size());
+            delivery.produce_mapped(topic, key.data(), key.size(), std::move(file));
+            result.bytes_logical += fsize;
+            continue;
+        }
+
         auto fsize = entry.file_size();
         std::ifstream f(entry.path(), std::ios::binary);
         std::vector<char> buf(fsize);
         f.read(buf.data(), static_cast<std::streamsize>(fsize));
+        if (tuning_.compacted_topics) key = SHA256::hash_hex(buf.data(), fsize);
+        delivery.produce(topic, key.data(), key.size(), buf.data(), fsize);
+        result.bytes_logical += fsize;
+    }
+#else
+    (void)dir; (void)topic; (void)delivery; (void)result;
+#endif
+}
 
-        std::string key = entry.path().filename().string();
+MeasureResult KafkaConnector::perfile_delete() {
+    LOG_INF("[kafka] Per-file delete: DeleteRecords on %s-{U0,U50,U90}, %lld records per step",
+        topic_prefix_.c_str(), static_cast<long long>(tuning_.delete_step));
+#ifdef DEDUP_DRY_RUN
+    return {};
+#endif
+    return delete_records(lab_topics());
+}
 
-        int64_t produce_ns = 0;
-        {
-            ScopedTimer st(produce_ns);
-            int err = rd_kafka_producev(rk,
-                RD_KAFKA_V_TOPIC(topic.c_str()),
-                RD_KAFKA_V_KEY(key.data(), key.size()),
-                RD_KAFKA_V_VALUE(buf.data(), fsize),
-                RD_KAFKA_V_MSGFLAGS(RD_KAFKA_MSG_F_COPY),
-                RD_KAFKA_V_END);
-            if (err == 0) result.rows_affected++;
-            rd_kafka_poll(rk, 0);
+std::vector<int32_t> KafkaConnector::partition_ids(const std::string& topic) {
+    std::vector<int32_t> ids;
+#ifdef HAS_RDKAFKA
+    if (!producer_) return ids;
+    auto* rk = static_cast<rd_kafka_t*>(producer_);
+    rd_kafka_topic_t* rkt = rd_kafka_topic_new(rk, topic.c_str(), nullptr);
+    if (!rkt) return ids;
+
+    const rd_kafka_metadata_t* metadata = nullptr;
+    if (rd_kafka_metadata(rk, 0, rkt, &metadata, 10000) == RD_KAFKA_RESP_ERR_NO_ERROR && metadata) {
+        for (int t = 0; t < metadata->topic_cnt; t++) {
+            if (std::string(metadata->topics[t].topic) != topic) continue;
+            for (int p = 0; p < metadata->topics[t].partition_cnt; p++)
+                ids.push_back(metadata->topics[t].partitions[p].id);
         }
-        result.per_file_latencies_ns.push_back(produce_ns);
-        result.bytes_logical += fsize;
+        rd_kafka_metadata_destroy(metadata);
     }
-
-    rd_kafka_flush(rk, 30000);
-    total_timer.stop();
-    result.duration_ns = total_timer.elapsed_ns();
-    LOG_INF("[kafka] Per-file produce: %lld msgs, %lld bytes, %lld ms",
-        result.rows_affected, result.bytes_logical, total_timer.elapsed_ms());
+    rd_kafka_topic_destroy(rkt);
+#else
+    (void)topic;
 #endif
-    return result;
+    return ids;
 }
 
-MeasureResult KafkaConnector::perfile_delete() {
+MeasureResult KafkaConnector::delete_records(const std::vector<std::string>& topics) {
     MeasureResult result{};
-    LOG_INF("[kafka] Per-file delete = recreate topics (delete + create)");
-    // Kafka has no per-message delete; we delete and recreate topics
+#ifdef HAS_RDKAFKA
+    if (!producer_) {
+        result.error = "not connected";
+        return result;
+    }
+    auto* rk = static_cast<rd_kafka_t*>(producer_);
+    const int64_t step = std::max<int64_t>(1, tuning_.delete_step);
+
+    Timer timer;
+    timer.start();
+    for (const auto& topic : topics) {
+        // [lo, hi) = records still present per partition
+        const std::vector<int32_t> parts = partition_ids(topic);
+        std::vector<int64_t> lo(parts.size(), 0), hi(parts.size(), 0);
+        for (size_t i = 0; i < parts.size(); ++i) {
+            if (rd_kafka_query_watermark_offsets(rk, topic.c_str(), parts[i], &lo[i], &hi[i], 5000) !=
+                RD_KAFKA_RESP_ERR_NO_ERROR) {
+                lo[i] = hi[i] = 0;
+            }
+        }
+
+        // One DeleteRecords request per step, advancing the low watermark of
+        // every partition that still has records by `step`
+        while (result.error.empty()) {
+            rd_kafka_topic_partition_list_t* offsets =
+                rd_kafka_topic_partition_list_new(static_cast<int>(parts.size()));
+            for (size_t i = 0; i < parts.size(); ++i) {
+                if (lo[i] >= hi[i]) continue;
+                rd_kafka_topic_partition_list_add(offsets, topic.c_str(), parts[i])->offset =
+                    std::min(lo[i] + step, hi[i]);
+            }
+            if (offsets->cnt == 0) {
+                rd_kafka_topic_partition_list_destroy(offsets);
+                break;
+            }
+            rd_kafka_DeleteRecords_t* del = rd_kafka_DeleteRecords_new(offsets);
+            rd_kafka_topic_partition_list_destroy(offsets);
+
+            rd_kafka_AdminOptions_t* options = rd_kafka_AdminOptions_new(rk, RD_KAFKA_ADMIN_OP_DELETERECORDS);
+            rd_kafka_AdminOptions_set_request_timeout(options, 30000, nullptr, 0);
+            rd_kafka_AdminOptions_set_operation_timeout(options, 30000, nullptr, 0);
+            rd_kafka_queue_t* queue = rd_kafka_queue_new(rk);
+
+            int64_t request_ns = 0;
+            rd_kafka_event_t* event = nullptr;
+            {
+                ScopedTimer st(request_ns);
+                rd_kafka_DeleteRecords(rk, &del, 1, options, queue);
+                event = rd_kafka_queue_poll(queue, 60000);
+            }
+
+            bool progressed = false;
+            if (!event) {
+                result.error = "DeleteRecords timed out on " + topic;
+            } else if (rd_kafka_event_error(event) != RD_KAFKA_RESP_ERR_NO_ERROR) {
+                result.error = "DeleteRecords on " + topic + ": " + rd_kafka_event_error_string(event);
+            } else {
+                const rd_kafka_topic_partition_list_t* done =
+                    rd_kafka_DeleteRecords_result_offsets(rd_kafka_event_DeleteRecords_result(event));
+                for (int e = 0; done && e < done->cnt; ++e) {
+                    const auto& tp = done->elems[e];
+                    for (size_t i = 0; i < parts.size(); ++i) {
+                        if (parts[i] != tp.partition) continue;
+                        if (tp.err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+                            LOG_ERR("[kafka] DeleteRecords %s[%d]: %s",
+                                topic.c_str(), tp.partition, rd_kafka_err2str(tp.err));
+                            lo[i] = hi[i];  // give up on this partition
+                        } else {
+                            // tp.offset = new low watermark
+                            result.rows_affected += tp.offset - lo[i];
+                            lo[i] = tp.offset;
+                            progressed = true;
+                        }
+                    }
+                }
+                result.per_file_latencies_ns.push_back(request_ns);
+            }
+            if (!result.error.empty()) LOG_ERR("[kafka] %s", result.error.c_str());
+
+            if (event) rd_kafka_event_destroy(event);
+            rd_kafka_queue_destroy(queue);
+            rd_kafka_AdminOptions_destroy(options);
+            rd_kafka_DeleteRecords_destroy(del);
+            if (!progressed && result.error.empty()) break;  // every partition failed
+        }
+    }
+    timer.stop();
+    result.duration_ns = timer.elapsed_ns();
+    LOG_INF("[kafka] DeleteRecords: %lld records in %zu requests, %lld ms",
+        result.rows_affected, result.per_file_latencies_ns.size(), timer.elapsed_ms());
+#else
+    (void)topics;
+    result.error = "Kafka not compiled";
+#endif
     return result;
 }
 
 MeasureResult KafkaConnector::run_maintenance() {
     MeasureResult result{};
-    LOG_INF("[kafka] Maintenance = log compaction + retention (Strimzi-managed, background)");
+    if (!tuning_.compacted_topics) {
+        LOG_INF("[kafka] Maintenance = log compaction + retention (Strimzi-managed, background)");
+        return result;
+    }
+#ifdef DEDUP_DRY_RUN
+    return result;
+#endif
+
+#ifdef HAS_RDKAFKA
+    // The cleaner never touches the active segment, and a segment only rolls
+    // on an append once it is older than segment.ms: wait for that, then
+    // append one marker per partition to roll every produced-to partition.
+    // The roll is set-up, not compaction: it stays outside the timed region.
+    auto roll_at = last_produce_ + std::chrono::milliseconds(tuning_.compaction_segment_ms);
+    if (roll_at > std::chrono::steady_clock::now()) {
+        LOG_INF("[kafka] Maintenance: waiting %lld ms for segment.ms before rolling",
+            static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                roll_at - std::chrono::steady_clock::now()).count()));
+        std::this_thread::sleep_until(roll_at);
+    }
+    {
+        auto* rk = static_cast<rd_kafka_t*>(producer_);
+        KafkaDelivery delivery(rk, result, false, false, tuning_.flush_timeout_ms);
+        static const char MARKER_KEY[] = "__segment_roll__";
+        for (const auto& topic : produced_topics_) {
+            for (int32_t p : partition_ids(topic))
+                delivery.produce(topic, MARKER_KEY, sizeof(MARKER_KEY) - 1, nullptr, 0, p);
+        }
+        delivery.finish();
+        result.rows_affected = 0;  // markers are not data
+        result.error.clear();
+    }
+
+    // Baseline after the markers, which grow the log themselves
+    Timer timer;
+    timer.start();
+    const int64_t before = lab_log_bytes();
+    LOG_INF("[kafka] Maintenance: waiting for log compaction (log size %lld bytes)",
+        static_cast<long long>(before));
+
+    // Compaction is done once the size holds still for stable_polls polls
+    // in a row (the cleaner works partition by partition). Whether it
+    // dropped does not matter: without duplicates there is nothing to drop.
+    const int stable_polls = std::max(tuning_.compaction_stable_polls, 1);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(tuning_.compaction_wait_s);
+    int64_t last = before, after = before;
+    int stable = 0;
+    while (before >= 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(tuning_.compaction_poll_ms));
+        after = lab_log_bytes();
+        if (after < 0) break;
+        stable = after == last ? stable + 1 : 0;
+        last = after;
+        if (stable >= stable_polls) break;
+    }
+    if (stable < stable_polls) {
+        LOG_WRN("[kafka] Compaction did not settle within %d s", tuning_.compaction_wait_s);
+    }
+
+    timer.stop();
+    result.duration_ns = timer.elapsed_ns();
+    // Reclaimed bytes: throughput of this stage = compaction rate
+    result.bytes_logical = (before >= 0 && after >= 0) ? before - after : 0;
+    LOG_INF("[kafka] Compaction: log size %lld -> %lld bytes (%lld reclaimed), %lld ms",
+        static_cast<long long>(before), static_cast<long long>(after),
+        result.bytes_logical, timer.elapsed_ms());
+#endif
     return result;
 }
 
+int64_t KafkaConnector::lab_log_bytes() {
+    KafkaLogDirSizes sizes;
+    if (log_dirs_ && log_dirs_->describe(topic_prefix_ + "-", sizes)) return sizes.logical;
+
+    // Fallback: Strimzi JMX exporter (port 9404): kafka_log_Log_Size{topic=...,partition=...}
+    auto resp = HttpClient::get("http://" + conn_.host + ":9404/metrics", 5, 2);
+    if (resp.curl_code != 0) return -1;
+    const std::string& body = resp.body;
+
+    const std::string topic_label = "topic=\"" + topic_prefix_ + "-";
+    int64_t total = 0;
+    std::istringstream iss(body);
+    std::string line;
+    while (std::getline(iss, line)) {
+        if (line.rfind("kafka_log_Log_Size{", 0) != 0) continue;
+        if (line.find(topic_label) == std::string::npos) continue;
+        size_t sp = line.rfind(' ');
+        if (sp != std::string::npos) total += static_cast<int64_t>(std::strtod(line.c_str() + sp + 1, nullptr));
+    }
+    return total;
+}
+
 int64_t KafkaConnector::get_logical_size_bytes() {
 #ifdef DEDUP_DRY_RUN
     return 0;
@@ -313,42 +659,14 @@ int64_t KafkaConnector::get_logical_size_bytes() {
 
 #ifdef HAS_RDKAFKA
     if (!producer_) return -1;
-    auto* rk = static_cast<rd_kafka_t*>(producer_);
-
-    int64_t total = 0;
-    const char* suffixes[] = {"U0", "U50", "U90"};
-
-    for (const auto& suffix : suffixes) {
-        std::string topic_name = topic_prefix_ + "-" + suffix;
-        rd_kafka_topic_t* rkt = rd_kafka_topic_new(rk, topic_name.c_str(), nullptr);
-        if (!rkt) continue;
-
-        // Get metadata to find partition count
-        const rd_kafka_metadata_t* metadata = nullptr;
-        rd_kafka_resp_err_t err = rd_kafka_metadata(rk, 0, rkt, &metadata, 10000);
-        if (err != RD_KAFKA_RESP_ERR_NO_ERROR || !metadata) {
-            rd_kafka_topic_destroy(rkt);
-            continue;
-        }
-
-        for (int t = 0; t < metadata->topic_cnt; t++) {
-            if (std::string(metadata->topics[t].topic) != topic_name) continue;
-            for (int p = 0; p < metadata->topics[t].partition_cnt; p++) {
-                int32_t partition = metadata->topics[t].partitions[p].id;
-                int64_t lo = 0, hi = 0;
-                rd_kafka_query_watermark_offsets(rk, topic_name.c_str(), partition, &lo, &hi, 5000);
-                // Approximate: (hi - lo) messages, but we don't know sizes without consuming
-                // Use metadata approximation
-                total += (hi - lo);
-            }
-        }
-
-        rd_kafka_metadata_destroy(metadata);
-        rd_kafka_topic_destroy(rkt);
+    // Segment bytes of all lab topics (one replica per partition); the
+    // broker counts them directly, no consume or exporter scrape needed
+    const int64_t total = lab_log_bytes();
+    if (total >= 0) {
+        LOG_INF("[kafka] Lab topic log size: %lld bytes", static_cast<long long>(total));
+    } else {
+        LOG_ERR("[kafka] Lab topic log size unavailable (DescribeLogDirs and JMX failed)");
     }
-
-    // Return message count as proxy (actual size requires consuming all messages)
-    LOG_INF("[kafka] Lab topic total messages (offset-based): %lld", total);
     return total;
 #else
     return -1;
@@ -361,12 +679,23 @@ int64_t KafkaConnector::get_logical_size_bytes() {
 // ============================================================================
 
 bool KafkaConnector::create_native_schema(const std::string& schema_name, PayloadType type) {
-    // Kafka topics are auto-created on produce
+    // Kafka topics are auto-created on produce; compacted topics need their
+    // cleanup policy up front
+    if (tuning_.compacted_topics) {
+#ifdef DEDUP_DRY_RUN
+        return true;
+#endif
+        return create_topics({topic_prefix_ + "-" + get_native_schema(type).table_name});
+    }
     LOG_INF("[kafka] Native schema for %s: topic auto-creation", payload_type_str(type));
     return true;
 }
 
 bool KafkaConnector::drop_native_schema(const std::string& schema_name, PayloadType type) {
+#ifndef DEDUP_DRY_RUN
+    delete_topics({topic_prefix_ + "-" + get_native_schema(type).table_name});
+#endif
+    produced_topics_.clear();
     return drop_lab_schema(schema_name);
 }
 
@@ -390,6 +719,7 @@ MeasureResult KafkaConnector::native_bulk_insert(
     Timer timer;
     timer.start();
 
+    KafkaDelivery delivery(rk, result, false, false, tuning_.flush_timeout_ms);
     for (const auto& rec : records) {
         // Serialize record as JSON
         std::string json_val = "{";
@@ -423,18 +753,18 @@ MeasureResult KafkaConnector::native_bulk_insert(
         }
         json_val += "}";
 
-        rd_kafka_resp_err_t err = rd_kafka_producev(
-            rk, RD_KAFKA_V_TOPIC(topic.c_str()),
-            RD_KAFKA_V_VALUE(json_val.data(), json_val.size()),
-            RD_KAFKA_V_END);
-
-        if (err == RD_KAFKA_RESP_ERR_NO_ERROR) {
-            result.rows_affected++;
+        if (tuning_.compacted_topics) {
+            const std::string key = SHA256::hash_hex(json_val.data(), json_val.size());
+            delivery.produce(topic, key.data(), key.size(), json_val.data(), json_val.size());
+        } else {
+            delivery.produce(topic, nullptr, 0, json_val.data(), json_val.size());
         }
         result.bytes_logical += static_cast<int64_t>(json_val.size());
     }
 
-    rd_kafka_flush(rk, 10000);  // Wait up to 10s for delivery
+    delivery.finish();
+    produced_topics_.insert(topic);
+    last_produce_ = std::chrono::steady_clock::now();
 
     timer.stop();
     result.duration_ns = timer.elapsed_ns();
@@ -463,6 +793,7 @@ MeasureResult KafkaConnector::native_perfile_insert(
     Timer total_timer;
     total_timer.start();
 
+    KafkaDelivery delivery(rk, result, true, tuning_.latency_breakdown, tuning_.flush_timeout_ms);
     for (const auto& rec : records) {
         std::string json_val = "{";
         bool first = true;
@@ -493,20 +824,18 @@ MeasureResult KafkaConnector::native_perfile_insert(
         }
         json_val += "}";
 
-        int64_t produce_ns = 0;
-        {
-            ScopedTimer st(produce_ns);
-            rd_kafka_producev(
-                rk, RD_KAFKA_V_TOPIC(topic.c_str()),
-                RD_KAFKA_V_VALUE(json_val.data(), json_val.size()),
-                RD_KAFKA_V_END);
-            result.rows_affected++;
+        if (tuning_.compacted_topics) {
+            const std::string key = SHA256::hash_hex(json_val.data(), json_val.size());
+            delivery.produce(topic, key.data(), key.size(), json_val.data(), json_val.size());
+        } else {
+            delivery.produce(topic, nullptr, 0, json_val.data(), json_val.size());
         }
-        result.per_file_latencies_ns.push_back(produce_ns);
         result.bytes_logical += static_cast<int64_t>(json_val.size());
     }
 
-    rd_kafka_flush(rk, 10000);
+    delivery.finish();
+    produced_topics_.insert(topic);
+    last_produce_ = std::chrono::steady_clock::now();
     total_timer.stop();
     result.duration_ns = total_timer.elapsed_ns();
 #else
@@ -516,8 +845,10 @@ MeasureResult KafkaConnector::native_perfile_insert(
 }
 
 MeasureResult KafkaConnector::native_perfile_delete(PayloadType type) {
-    // Kafka has no per-record delete -- same as BLOB (topic deletion)
-    return perfile_delete();
+#ifdef DEDUP_DRY_RUN
+    return {};
+#endif
+    return delete_records({topic_prefix_ + "-" + get_native_schema(type).table_name});
 }
 
 int64_t KafkaConnector::get_native_logical_size_bytes(PayloadType type) {
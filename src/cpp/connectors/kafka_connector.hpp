@@ -1,12 +1,29 @@
 #pragma once
 #include "db_connector.hpp"
+#include "kafka_log_dirs.hpp"
+#include <chrono>
+#include <memory>
+#include <set>
 
 namespace dedup {
 
+class KafkaDelivery;
+
 // Kafka connector -- uses topic prefix "dedup-lab-*" for isolation
 // Production topics are NEVER touched
+// Every produce stage tracks delivery reports (KafkaDelivery): rows are
+// acknowledged messages and per-file latency is producev() to broker ack
+// at KafkaTuning::acks. With KafkaTuning::zero_copy the blob stages
+// produce memory-mapped files by reference instead of reading and copying.
+// KafkaTuning::producer_profiles (compression / linger / batch / acks) are
+// run as variants, each with a freshly created producer.
+// Per-file delete advances the low watermarks with DeleteRecords. With
+// KafkaTuning::compacted_topics messages are keyed by payload SHA-256 on
+// compacted topics and maintenance waits for the log cleaner.
+// Logical size is the lab topics' segment bytes per DescribeLogDirs.
 class KafkaConnector : public DbConnector {
 public:
+    explicit KafkaConnector(const KafkaTuning& tuning = {}) : tuning_(tuning) {}
     ~KafkaConnector() override { disconnect(); }
 
     bool connect(const DbConnection& conn) override;
@@ -36,10 +53,50 @@ public:
     MeasureResult native_perfile_delete(PayloadType type) override;
     int64_t get_native_logical_size_bytes(PayloadType type) override;
 
+    // Producer profiles (KafkaTuning::producer_profiles)
+    [[nodiscard]] std::vector<std::string> variants() const override;
+    bool select_variant(const std::string& name) override;
+    [[nodiscard]] std::string current_variant() const override {
+        return profile_ ? profile_->label() : "";
+    }
+
 private:
+    std::vector<std::string> lab_topics() const;  // <prefix>-{U0,U50,U90}
+    // AdminClient CreateTopics (4 partitions, RF 3; compacted if configured)
+    // / DeleteTopics, one request per topic
+    bool create_topics(const std::vector<std::string>& names);
+    bool delete_topics(const std::vector<std::string>& names);
+    std::vector<int32_t> partition_ids(const std::string& topic);
+
+    // DeleteRecords over all partitions of `topics`, KafkaTuning::delete_step
+    // records per partition and request; one latency sample per request,
+    // rows_affected = records removed
+    MeasureResult delete_records(const std::vector<std::string>& topics);
+
+    // Bytes on disk of all lab topics, one replica per partition:
+    // DescribeLogDirs through log_dirs_, falling back to kafka_log_Log_Size
+    // from the broker's JMX exporter; -1 if neither answers
+    int64_t lab_log_bytes();
+
+    // Produce every file of `dir` to `topic` (mmap'd with zero_copy, else
+    // read and copied)
+    void produce_files(const std::string& dir, const std::string& topic,
+                       KafkaDelivery& delivery, MeasureResult& result);
+
+    // rd_kafka_new() with the tuning defaults and the selected profile
+    bool create_producer();
+    void destroy_producer();  // flushes first
+
+    KafkaTuning tuning_;
+    DbConnection conn_{};
+    // Selected profile (points into tuning_.producer_profiles)
+    const KafkaProducerProfile* profile_ = nullptr;
     std::string bootstrap_;
+    std::set<std::string> produced_topics_;  // since the last drop
+    std::chrono::steady_clock::time_point last_produce_{};
     std::string topic_prefix_ = "dedup-lab";
     void* producer_ = nullptr;  // rd_kafka_t*
+    std::unique_ptr<KafkaLogDirs> log_dirs_;  // broker sockets kept between calls
     bool connected_ = false;
 };
 
@@ -0,0 +1,146 @@
+#include "kafka_delivery.hpp"
+#include "../utils/logger.hpp"
+#include "../utils/timer.hpp"
+
+#ifdef HAS_RDKAFKA
+#include <librdkafka/rdkafka.h>
+#endif
+
+namespace dedup {
+
+#ifdef HAS_RDKAFKA
+
+bool KafkaDelivery::produce(const std::string& topic, const void* key, size_t key_len,
+                            const void* value, size_t len, int32_t partition) {
+    slots_.emplace_back();
+    return send(topic, key, key_len, value, len, RD_KAFKA_MSG_F_COPY, partition);
+}
+
+bool KafkaDelivery::produce_mapped(const std::string& topic, const void* key, size_t key_len,
+                                   MappedFile file) {
+    const auto size = static_cast<int64_t>(file.size());
+    // Backpressure: mapped payloads stay resident until acknowledged. One
+    // oversized file is let through alone.
+    while (max_inflight_bytes_ > 0 && inflight_bytes_ > 0 &&
+           inflight_bytes_ + size > max_inflight_bytes_) {
+        rd_kafka_poll(rk_, 100);
+    }
+
+    slots_.emplace_back();
+    Slot& slot = slots_.back();
+    slot.mapping = std::move(file);
+    slot.owner = this;
+    inflight_bytes_ += size;
+    // No RD_KAFKA_MSG_F_COPY: librdkafka references the mapping until the
+    // delivery report (payloads above message.copy.max.bytes go to the
+    // socket as their own iovec)
+    return send(topic, key, key_len, slot.mapping.data(), slot.mapping.size(), 0);
+}
+
+bool KafkaDelivery::send(const std::string& topic, const void* key, size_t key_len,
+                         const void* value, size_t len, int msgflags, int32_t partition) {
+    Slot& slot = slots_.back();
+
+    int64_t enqueue_ns = 0;
+    rd_kafka_resp_err_t err;
+    {
+        ScopedTimer st(enqueue_ns);
+        slot.sent = std::chrono::steady_clock::now();
+        while (true) {
+            err = rd_kafka_producev(rk_,
+                RD_KAFKA_V_TOPIC(topic.c_str()),
+                RD_KAFKA_V_PARTITION(partition),
+                RD_KAFKA_V_KEY(const_cast<void*>(key), key_len),
+                RD_KAFKA_V_VALUE(const_cast<void*>(value), len),
+                RD_KAFKA_V_MSGFLAGS(msgflags),
+                RD_KAFKA_V_OPAQUE(&slot),
+                RD_KAFKA_V_END);
+            if (err != RD_KAFKA_RESP_ERR__QUEUE_FULL) break;
+            // Local queue full: serve delivery reports until there is room
+            rd_kafka_poll(rk_, 100);
+        }
+        rd_kafka_poll(rk_, 0);
+    }
+
+    if (err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+        LOG_ERR("[kafka] producev to %s failed: %s", topic.c_str(), rd_kafka_err2str(err));
+        release(slot);
+        slots_.pop_back();  // no report will come for it
+        return false;
+    }
+    if (breakdown_) result_.enqueue_latencies_ns.push_back(enqueue_ns);
+    return true;
+}
+
+void KafkaDelivery::release(Slot& slot) {
+    if (!slot.owner) return;
+    slot.owner->inflight_bytes_ -= static_cast<int64_t>(slot.mapping.size());
+    slot.mapping.reset();
+    slot.owner = nullptr;
+}
+
+void KafkaDelivery::on_delivery(rd_kafka_s*, const rd_kafka_message_s* msg, void*) {
+    auto* slot = static_cast<Slot*>(msg->_private);
+    if (!slot) return;  // produced without a tracker
+    // librdkafka's own producev -> ack time (microseconds), independent of
+    // when the report is served; -1 if it has none (e.g. a purged message)
+    const int64_t latency_us = rd_kafka_message_latency(msg);
+    slot->ack_ns = latency_us >= 0
+        ? latency_us * 1000
+        : std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::steady_clock::now() - slot->sent).count();
+    slot->err = msg->err;
+    release(*slot);  // librdkafka is done with the payload
+}
+
+void KafkaDelivery::finish() {
+    if (finished_) return;
+    finished_ = true;
+
+    if (rd_kafka_flush(rk_, flush_timeout_ms_) != RD_KAFKA_RESP_ERR_NO_ERROR) {
+        // Purged messages get an __PURGE_* report on the next flush
+        LOG_WRN("[kafka] %d messages unacknowledged after %d ms -- purging",
+            rd_kafka_outq_len(rk_), flush_timeout_ms_);
+        rd_kafka_purge(rk_, RD_KAFKA_PURGE_F_QUEUE | RD_KAFKA_PURGE_F_INFLIGHT);
+        rd_kafka_flush(rk_, 5000);
+    }
+
+    int64_t failed = 0;
+    for (const auto& slot : slots_) {
+        if (slot.ack_ns < 0 || slot.err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+            // Log the first few only; a broker outage would flood the log
+            if (failed < 10 && slot.ack_ns >= 0) {
+                LOG_ERR("[kafka] Delivery failed: %s",
+                    rd_kafka_err2str(static_cast<rd_kafka_resp_err_t>(slot.err)));
+            }
+            ++failed;
+            continue;
+        }
+        result_.rows_affected++;
+        if (track_latency_) result_.per_file_latencies_ns.push_back(slot.ack_ns);
+    }
+    if (failed > 0 && result_.error.empty()) {
+        result_.error = std::to_string(failed) + " of " + std::to_string(slots_.size()) +
+                        " messages not acknowledged";
+    }
+    slots_.clear();
+}
+
+#else
+
+bool KafkaDelivery::produce(const std::string&, const void*, size_t, const void*, size_t, int32_t) {
+    return false;
+}
+bool KafkaDelivery::produce_mapped(const std::string&, const void*, size_t, MappedFile) {
+    return false;
+}
+bool KafkaDelivery::send(const std::string&, const void*, size_t, const void*, size_t, int, int32_t) {
+    return false;
+}
+void KafkaDelivery::release(Slot& slot) { slot.mapping.reset(); }
+void KafkaDelivery::on_delivery(rd_kafka_s*, const rd_kafka_message_s*, void*) {}
+void KafkaDelivery::finish() { finished_ = true; }
+
+#endif
+
+} // namespace dedup
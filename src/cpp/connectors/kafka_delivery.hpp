@@ -0,0 +1,90 @@
+#pragma once
+// Delivery-report tracking for Kafka produce stages
+//
+// Every message is produced with a pointer to its own slot as per-message
+// opaque; the producer's dr_msg_cb (KafkaDelivery::on_delivery) records the
+// outcome in that slot. Latency of message i = time from producev() to its
+// delivery report, i.e. broker acknowledgement at the producer's acks level
+// (acks=0: until the request was written), as measured by librdkafka
+// itself (rd_kafka_message_latency) -- not when the report happens to be
+// served by the next poll, which would add the client's work in between.
+//
+// Reports are served by rd_kafka_poll()/rd_kafka_flush() on the producing
+// thread, so slots need no locking. finish() flushes and purges whatever is
+// still unacknowledged, so no report can reach a destroyed tracker.
+//
+// produce_mapped() sends a memory-mapped file without any copy: the slot
+// owns the mapping until the delivery report, and at most
+// max_inflight_bytes of mapped payload are outstanding at a time.
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include "db_connector.hpp"
+#include "../utils/mapped_file.hpp"
+
+struct rd_kafka_s;
+struct rd_kafka_message_s;
+
+namespace dedup {
+
+class KafkaDelivery {
+public:
+    // Acknowledged messages go to result.rows_affected, their latencies to
+    // per_file_latencies_ns if track_latency (and the producev + poll share
+    // to enqueue_latencies_ns if breakdown)
+    KafkaDelivery(rd_kafka_s* rk, MeasureResult& result, bool track_latency,
+                  bool breakdown, int flush_timeout_ms, int64_t max_inflight_bytes = 0)
+        : rk_(rk), result_(result), track_latency_(track_latency),
+          breakdown_(track_latency && breakdown), flush_timeout_ms_(flush_timeout_ms),
+          max_inflight_bytes_(max_inflight_bytes) {}
+
+    ~KafkaDelivery() { finish(); }
+
+    KafkaDelivery(const KafkaDelivery&) = delete;
+    KafkaDelivery& operator=(const KafkaDelivery&) = delete;
+
+    // producev() a copy of key/value, waiting for queue space on QUEUE_FULL;
+    // false if the message could not be enqueued. partition -1 = partitioner
+    bool produce(const std::string& topic, const void* key, size_t key_len,
+                 const void* value, size_t len, int32_t partition = -1);
+
+    // producev() the mapped file by reference (key still copied); waits
+    // while max_inflight_bytes (0 = unbounded) of mappings are unacknowledged
+    bool produce_mapped(const std::string& topic, const void* key, size_t key_len,
+                        MappedFile file);
+
+    // Wait for all outstanding reports (purging after flush_timeout_ms) and
+    // fold the results in; called by the destructor
+    void finish();
+
+    // dr_msg_cb for rd_kafka_conf_set_dr_msg_cb()
+    static void on_delivery(rd_kafka_s* rk, const rd_kafka_message_s* msg, void* opaque);
+
+private:
+    struct Slot {
+        std::chrono::steady_clock::time_point sent;  // fallback if librdkafka has no latency
+        int64_t ack_ns = -1;  // producev() -> delivery report
+        int err = 0;          // rd_kafka_resp_err_t of the report
+        MappedFile mapping;   // zero-copy payload, released on report
+        KafkaDelivery* owner = nullptr;  // set while mapping counts as in flight
+    };
+
+    rd_kafka_s* rk_;
+    MeasureResult& result_;
+    bool track_latency_;
+    bool breakdown_;
+    int flush_timeout_ms_;
+    int64_t max_inflight_bytes_;
+    int64_t inflight_bytes_ = 0;
+    std::deque<Slot> slots_;  // deque: opaques stay valid while it grows
+    bool finished_ = false;
+
+    // producev() for slots_.back(); pops the slot again on failure
+    bool send(const std::string& topic, const void* key, size_t key_len,
+              const void* value, size_t len, int msgflags, int32_t partition = -1);
+    static void release(Slot& slot);
+};
+
+} // namespace dedup
@@ -0,0 +1,421 @@
+#include "kafka_log_dirs.hpp"
+#include "../utils/logger.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#ifdef HAS_OPENSSL
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/rand.h>
+#include <openssl/sha.h>
+#endif
+
+namespace dedup {
+
+namespace {
+
+// API keys / versions (all pre-flexible, so no tagged fields anywhere)
+constexpr int16_t API_METADATA = 3;
+constexpr int16_t API_SASL_HANDSHAKE = 17;
+constexpr int16_t API_DESCRIBE_LOG_DIRS = 35;
+constexpr int16_t API_SASL_AUTHENTICATE = 36;
+
+// --- Big-endian encoding ---
+
+void put_i16(std::string& b, int16_t v) {
+    b.push_back(static_cast<char>((v >> 8) & 0xff));
+    b.push_back(static_cast<char>(v & 0xff));
+}
+
+void put_i32(std::string& b, int32_t v) {
+    for (int s = 24; s >= 0; s -= 8) b.push_back(static_cast<char>((v >> s) & 0xff));
+}
+
+void put_str(std::string& b, const std::string& s) {
+    put_i16(b, static_cast<int16_t>(s.size()));
+    b += s;
+}
+
+void put_bytes(std::string& b, const std::string& s) {
+    put_i32(b, static_cast<int32_t>(s.size()));
+    b += s;
+}
+
+// Bounds-checked decoder; any overrun latches ok = false
+struct Reader {
+    const std::string& b;
+    size_t pos = 0;
+    bool ok = true;
+
+    bool need(size_t n) {
+        if (!ok || b.size() - pos < n) ok = false;
+        return ok;
+    }
+    int64_t be(size_t n) {
+        if (!need(n)) return 0;
+        uint64_t v = 0;
+        for (size_t i = 0; i < n; ++i) v = (v << 8) | static_cast<unsigned char>(b[pos + i]);
+        pos += n;
+        // sign-extend
+        if (n < 8 && (v >> (n * 8 - 1)) & 1) v |= ~uint64_t{0} << (n * 8);
+        return static_cast<int64_t>(v);
+    }
+    int8_t i8() { return static_cast<int8_t>(be(1)); }
+    int16_t i16() { return static_cast<int16_t>(be(2)); }
+    int32_t i32() { return static_cast<int32_t>(be(4)); }
+    int64_t i64() { return be(8); }
+    std::string str() {  // nullable: -1 -> ""
+        int16_t n = i16();
+        if (n < 0 || !need(static_cast<size_t>(n))) return {};
+        std::string s = b.substr(pos, static_cast<size_t>(n));
+        pos += static_cast<size_t>(n);
+        return s;
+    }
+    std::string bytes() {
+        int32_t n = i32();
+        if (n < 0 || !need(static_cast<size_t>(n))) return {};
+        std::string s = b.substr(pos, static_cast<size_t>(n));
+        pos += static_cast<size_t>(n);
+        return s;
+    }
+};
+
+bool send_all(int fd, const std::string& data) {
+    size_t off = 0;
+    while (off < data.size()) {
+        ssize_t n = ::send(fd, data.data() + off, data.size() - off, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        off += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool recv_all(int fd, char* buf, size_t len) {
+    size_t off = 0;
+    while (off < len) {
+        ssize_t n = ::recv(fd, buf + off, len - off, 0);
+        if (n <= 0) return false;  // closed or SO_RCVTIMEO
+        off += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+#ifdef HAS_OPENSSL
+
+std::string b64_encode(const std::string& in) {
+    std::string out(4 * ((in.size() + 2) / 3), '\0');
+    int n = EVP_EncodeBlock(reinterpret_cast<unsigned char*>(out.data()),
+                            reinterpret_cast<const unsigned char*>(in.data()),
+                            static_cast<int>(in.size()));
+    out.resize(n < 0 ? 0 : static_cast<size_t>(n));
+    return out;
+}
+
+std::string b64_decode(const std::string& in) {
+    if (in.empty() || in.size() % 4 != 0) return {};
+    std::string out(in.size() / 4 * 3, '\0');
+    int n = EVP_DecodeBlock(reinterpret_cast<unsigned char*>(out.data()),
+                            reinterpret_cast<const unsigned char*>(in.data()),
+                            static_cast<int>(in.size()));
+    if (n < 0) return {};
+    // EVP_DecodeBlock counts the '=' padding as zero bytes
+    size_t pad = (in[in.size() - 1] == '=') + (in[in.size() - 2] == '=');
+    out.resize(static_cast<size_t>(n) - pad);
+    return out;
+}
+
+std::string hmac512(const std::string& key, const std::string& msg) {
+    unsigned char md[EVP_MAX_MD_SIZE];
+    unsigned int len = 0;
+    HMAC(EVP_sha512(), key.data(), static_cast<int>(key.size()),
+         reinterpret_cast<const unsigned char*>(msg.data()), msg.size(), md, &len);
+    return std::string(reinterpret_cast<char*>(md), len);
+}
+
+// "k=v,k=v,..." attribute lookup of a SCRAM message
+std::string scram_attr(const std::string& msg, char key) {
+    size_t pos = 0;
+    while (pos < msg.size()) {
+        size_t end = msg.find(',', pos);
+        if (end == std::string::npos) end = msg.size();
+        if (end - pos >= 2 && msg[pos] == key && msg[pos + 1] == '=')
+            return msg.substr(pos + 2, end - pos - 2);
+        pos = end + 1;
+    }
+    return {};
+}
+
+#endif
+
+} // namespace
+
+// --- Connection handling ---
+
+int KafkaLogDirs::open(const std::string& host, int port) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* res = nullptr;
+    if (::getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &res) != 0 || !res) {
+        LOG_DBG("[kafka] log dirs: cannot resolve %s", host.c_str());
+        return -1;
+    }
+    int fd = -1;
+    for (addrinfo* ai = res; ai; ai = ai->ai_next) {
+        fd = ::socket(ai->ai_family, ai->ai_socktype | SOCK_CLOEXEC, ai->ai_protocol);
+        if (fd < 0) continue;
+        timeval tv{5, 0};
+        ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+        int one = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        if (::connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) break;
+        ::close(fd);
+        fd = -1;
+    }
+    ::freeaddrinfo(res);
+    if (fd < 0) {
+        LOG_DBG("[kafka] log dirs: connect to %s:%d failed", host.c_str(), port);
+        return -1;
+    }
+    if (!user_.empty() && !sasl_scram(fd)) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+void KafkaLogDirs::close() {
+    for (auto& b : brokers_) {
+        if (b.fd >= 0) ::close(b.fd);
+    }
+    brokers_.clear();
+}
+
+bool KafkaLogDirs::request(int fd, int16_t api_key, int16_t version, const std::string& body,
+                           std::string& response) {
+    const int32_t corr = ++correlation_;
+    // Request header v1: api_key, api_version, correlation_id, client_id
+    std::string msg;
+    put_i16(msg, api_key);
+    put_i16(msg, version);
+    put_i32(msg, corr);
+    put_str(msg, "dedup-test");
+    msg += body;
+    std::string frame;
+    put_i32(frame, static_cast<int32_t>(msg.size()));
+    frame += msg;
+    if (!send_all(fd, frame)) return false;
+
+    char hdr[4];
+    if (!recv_all(fd, hdr, 4)) return false;
+    std::string size_buf(hdr, 4);
+    Reader sr{size_buf};
+    const int32_t size = sr.i32();
+    if (size < 4 || size > (64 << 20)) return false;
+    std::string payload(static_cast<size_t>(size), '\0');
+    if (!recv_all(fd, payload.data(), payload.size())) return false;
+
+    // Response header v0: correlation_id
+    Reader r{payload};
+    if (r.i32() != corr) return false;
+    response = payload.substr(4);
+    return true;
+}
+
+bool KafkaLogDirs::sasl_scram(int fd) {
+#ifdef HAS_OPENSSL
+    std::string body, resp;
+    put_str(body, "SCRAM-SHA-512");
+    if (!request(fd, API_SASL_HANDSHAKE, 1, body, resp)) return false;
+    if (int16_t err = Reader{resp}.i16(); err != 0) {
+        LOG_ERR("[kafka] log dirs: SaslHandshake rejected SCRAM-SHA-512 (error %d)", err);
+        denied_ = true;
+        return false;
+    }
+
+    // RFC 5802 username escaping
+    std::string name;
+    for (char c : user_) {
+        if (c == '=') name += "=3D";
+        else if (c == ',') name += "=2C";
+        else name += c;
+    }
+    unsigned char raw_nonce[18];
+    RAND_bytes(raw_nonce, sizeof(raw_nonce));
+    const std::string nonce = b64_encode(std::string(reinterpret_cast<char*>(raw_nonce), sizeof(raw_nonce)));
+    const std::string client_first_bare = "n=" + name + ",r=" + nonce;
+
+    // Round trip via SaslAuthenticate v1: error, message, auth bytes, lifetime
+    auto authenticate = [&](const std::string& out, std::string& in) {
+        std::string b, rsp;
+        put_bytes(b, out);
+        if (!request(fd, API_SASL_AUTHENTICATE, 1, b, rsp)) return false;
+        Reader r{rsp};
+        int16_t err = r.i16();
+        std::string errmsg = r.str();
+        in = r.bytes();
+        if (!r.ok || err != 0) {
+            LOG_ERR("[kafka] log dirs: SCRAM authentication failed (error %d%s%s)",
+                err, errmsg.empty() ? "" : ": ", errmsg.c_str());
+            denied_ = r.ok;  // a truncated reply is a transport problem
+            return false;
+        }
+        return true;
+    };
+
+    std::string server_first;
+    if (!authenticate("n,," + client_first_bare, server_first)) return false;
+    const std::string server_nonce = scram_attr(server_first, 'r');
+    const std::string salt = b64_decode(scram_attr(server_first, 's'));
+    const int iterations = std::atoi(scram_attr(server_first, 'i').c_str());
+    if (server_nonce.compare(0, nonce.size(), nonce) != 0 || salt.empty() || iterations <= 0) {
+        LOG_ERR("[kafka] log dirs: malformed SCRAM server-first message");
+        return false;
+    }
+
+    std::string salted(SHA512_DIGEST_LENGTH, '\0');
+    PKCS5_PBKDF2_HMAC(password_.data(), static_cast<int>(password_.size()),
+                      reinterpret_cast<const unsigned char*>(salt.data()), static_cast<int>(salt.size()),
+                      iterations, EVP_sha512(), SHA512_DIGEST_LENGTH,
+                      reinterpret_cast<unsigned char*>(salted.data()));
+    const std::string client_key = hmac512(salted, "Client Key");
+    std::string stored_key(SHA512_DIGEST_LENGTH, '\0');
+    SHA512(reinterpret_cast<const unsigned char*>(client_key.data()), client_key.size(),
+           reinterpret_cast<unsigned char*>(stored_key.data()));
+
+    const std::string final_no_proof = "c=biws,r=" + server_nonce;  // biws = b64("n,,")
+    const std::string auth_message = client_first_bare + "," + server_first + "," + final_no_proof;
+    std::string proof = hmac512(stored_key, auth_message);
+    for (size_t i = 0; i < proof.size(); ++i) proof[i] ^= client_key[i];
+
+    std::string server_final;
+    if (!authenticate(final_no_proof + ",p=" + b64_encode(proof), server_final)) return false;
+    const std::string server_key = hmac512(salted, "Server Key");
+    if (scram_attr(server_final, 'v') != b64_encode(hmac512(server_key, auth_message))) {
+        LOG_ERR("[kafka] log dirs: SCRAM server signature mismatch");
+        denied_ = true;
+        return false;
+    }
+    return true;
+#else
+    (void)fd;
+    LOG_ERR("[kafka] log dirs: SCRAM auth needs OpenSSL (built without HAS_OPENSSL)");
+    denied_ = true;
+    return false;
+#endif
+}
+
+bool KafkaLogDirs::refresh_brokers() {
+    close();
+    int fd = open(host_, port_);
+    if (fd < 0) return false;
+
+    // Metadata v1 with an empty topic array: brokers only
+    std::string body, resp;
+    put_i32(body, 0);
+    bool ok = request(fd, API_METADATA, 1, body, resp);
+    ::close(fd);
+    if (!ok) return false;
+
+    Reader r{resp};
+    int32_t n = r.i32();
+    for (int32_t i = 0; i < n && r.ok; ++i) {
+        Broker b;
+        b.id = r.i32();
+        b.host = r.str();
+        b.port = r.i32();
+        r.str();  // rack
+        brokers_.push_back(std::move(b));
+    }
+    if (!r.ok || brokers_.empty()) {
+        brokers_.clear();
+        return false;
+    }
+    return true;
+}
+
+bool KafkaLogDirs::fail() {
+    close();
+    if (denied_) {
+        LOG_WRN("[kafka] log dirs: access denied, lab log size sampling disabled");
+    } else {
+        retry_after_ = std::chrono::steady_clock::now() + RETRY_INTERVAL;
+        LOG_DBG("[kafka] log dirs: retrying in %lld s",
+            static_cast<long long>(RETRY_INTERVAL.count()));
+    }
+    return false;
+}
+
+// --- DescribeLogDirs ---
+
+bool KafkaLogDirs::describe(const std::string& topic_prefix, KafkaLogDirSizes& out) {
+    out = {};
+    if (denied_ || std::chrono::steady_clock::now() < retry_after_) return false;
+    if (brokers_.empty() && !refresh_brokers()) return fail();
+
+    // Null topic array = every partition the broker hosts (filtering by name
+    // would need a Metadata round trip per call to expand the prefix)
+    std::string body;
+    put_i32(body, -1);
+
+    std::map<std::pair<std::string, int32_t>, int64_t> largest;  // replica max per partition
+    for (auto& b : brokers_) {
+        std::string resp;
+        if (b.fd < 0) b.fd = open(b.host, b.port);
+        if (b.fd < 0 || !request(b.fd, API_DESCRIBE_LOG_DIRS, 1, body, resp)) {
+            // Broker gone or moved: drop all sockets, re-resolve after RETRY_INTERVAL
+            LOG_DBG("[kafka] log dirs: DescribeLogDirs on broker %d (%s:%d) failed",
+                b.id, b.host.c_str(), b.port);
+            return fail();
+        }
+
+        Reader r{resp};
+        r.i32();  // throttle_time_ms
+        int32_t dirs = r.i32();
+        for (int32_t d = 0; d < dirs && r.ok; ++d) {
+            int16_t err = r.i16();
+            r.str();  // log dir path
+            int32_t topics = r.i32();
+            for (int32_t t = 0; t < topics && r.ok; ++t) {
+                std::string name = r.str();
+                const bool match = name.compare(0, topic_prefix.size(), topic_prefix) == 0;
+                int32_t parts = r.i32();
+                for (int32_t p = 0; p < parts && r.ok; ++p) {
+                    int32_t index = r.i32();
+                    int64_t size = r.i64();
+                    r.i64();  // offset lag
+                    bool future = r.i8() != 0;
+                    if (!match || future || err != 0) continue;
+                    out.replicas += size;
+                    auto& m = largest[{name, index}];
+                    if (size > m) m = size;
+                }
+            }
+            if (err != 0) {
+                // CLUSTER_AUTHORIZATION_FAILED (31) comes back per log dir
+                LOG_DBG("[kafka] log dirs: broker %d reports error %d", b.id, err);
+                if (err == 31) {
+                    denied_ = true;
+                    return fail();
+                }
+            }
+        }
+        if (!r.ok) {
+            LOG_DBG("[kafka] log dirs: truncated DescribeLogDirs response from broker %d", b.id);
+            return fail();
+        }
+    }
+
+    for (const auto& [key, size] : largest) out.logical += size;
+    out.partitions = static_cast<int>(largest.size());
+    return true;
+}
+
+} // namespace dedup
@@ -1,8 +1,9 @@
 #include "minio_connector.hpp"
+#include "s3_uploader.hpp"
 #include "../utils/logger.hpp"
 #include "../utils/timer.hpp"
 #include "../utils/sha256.hpp"
-#include <curl/curl.h>
+#include "../utils/md5.hpp"
 #include <filesystem>
 #include <fstream>
 #include <sstream>
@@ -13,12 +14,6 @@
 namespace dedup {
 namespace fs = std::filesystem;
 
-// ---- curl write callback ----
-static size_t curl_write_cb(char* ptr, size_t size, size_t nmemb, std::string* data) {
-    data->append(ptr, size * nmemb);
-    return size * nmemb;
-}
-
 // ---- HMAC-SHA256 for AWS Signature V4 ----
 static std::array<uint8_t, 32> hmac_sha256(const uint8_t* key, size_t key_len,
                                              const void* msg, size_t msg_len) {
@@ -56,19 +51,6 @@ static std::array<uint8_t, 32> hmac_sha256_str(const uint8_t* key, size_t key_le
 }
 
 // ---- AWS Signature V4 signing ----
-static std::string get_utc_date() {
-    time_t t = time(nullptr);
-    struct tm tm_buf{};
-#ifdef _WIN32
-    gmtime_s(&tm_buf, &t);
-#else
-    gmtime_r(&t, &tm_buf);
-#endif
-    char buf[16];
-    std::strftime(buf, sizeof(buf), "%Y%m%d", &tm_buf);
-    return buf;
-}
-
 static std::string get_utc_datetime() {
     time_t t = time(nullptr);
     struct tm tm_buf{};
@@ -82,25 +64,56 @@ static std::string get_utc_datetime() {
     return buf;
 }
 
+// SigV4 canonical query string: parameters sorted by name, a bare name
+// ("?uploads") as "name=". Values are expected URI-encoded already.
+static std::string canonical_query(const std::string& query) {
+    std::vector<std::string> params;
+    size_t pos = 0;
+    while (pos <= query.size()) {
+        size_t amp = query.find('&', pos);
+        if (amp == std::string::npos) amp = query.size();
+        std::string p = query.substr(pos, amp - pos);
+        if (!p.empty()) params.push_back(p.find('=') == std::string::npos ? p + "=" : p);
+        pos = amp + 1;
+    }
+    std::sort(params.begin(), params.end());
+    std::string out;
+    for (const auto& p : params) {
+        if (!out.empty()) out += '&';
+        out += p;
+    }
+    return out;
+}
+
 // Generate Authorization header for S3 request
 std::string MinioConnector::s3_sign_request(const std::string& method,
                                              const std::string& path,
-                                             const std::string& payload_hash) {
-    std::string date = get_utc_date();
+                                             const std::string& payload_hash,
+                                             const std::string& fingerprint) {
+    const size_t q = path.find('?');
+    const std::string uri = path.substr(0, q);
+    const std::string query = q == std::string::npos ? "" : canonical_query(path.substr(q + 1));
+
     std::string datetime = get_utc_datetime();
-    std::string region = "us-east-1";
-    std::string service = "s3";
+    std::string date = datetime.substr(0, 8);  // same second as x-amz-date
+    static const std::string region = "us-east-1";
+    static const std::string service = "s3";
     std::string scope = date + "/" + region + "/" + service + "/aws4_request";
 
+    // Every x-amz-* header sent must be signed
+    std::string signed_headers = "host;x-amz-content-sha256;x-amz-date";
+    if (!fingerprint.empty()) signed_headers += ";x-amz-meta-sha256";
+
     // Canonical request
     std::string canonical = method + "\n"
-        + path + "\n"
-        + "\n"  // no query string
+        + uri + "\n"
+        + query + "\n"
         + "host:" + s3_host_ + "\n"
         + "x-amz-content-sha256:" + payload_hash + "\n"
         + "x-amz-date:" + datetime + "\n"
+        + (fingerprint.empty() ? "" : "x-amz-meta-sha256:" + fingerprint + "\n")
         + "\n"
-        + "host;x-amz-content-sha256;x-amz-date\n"
+        + signed_headers + "\n"
         + payload_hash;
 
     std::string canonical_hash = SHA256::hash_hex(canonical.data(), canonical.size());
@@ -108,21 +121,25 @@ std::string MinioConnector::s3_sign_request(const std::string& method,
     // String to sign
     std::string string_to_sign = "AWS4-HMAC-SHA256\n" + datetime + "\n" + scope + "\n" + canonical_hash;
 
-    // Signing key: HMAC chain
-    std::string key_str = "AWS4" + secret_key_;
-    auto k_date = hmac_sha256_str(reinterpret_cast<const uint8_t*>(key_str.data()),
-                                   key_str.size(), date);
-    auto k_region = hmac_sha256_str(k_date.data(), 32, region);
-    auto k_service = hmac_sha256_str(k_region.data(), 32, service);
-    auto k_signing = hmac_sha256_str(k_service.data(), 32, "aws4_request");
+    // Signing key: HMAC chain over date / region / service. It only changes
+    // with the scope, i.e. once a day, so it is derived once per scope.
+    if (scope != signing_scope_) {
+        std::string key_str = "AWS4" + secret_key_;
+        auto k_date = hmac_sha256_str(reinterpret_cast<const uint8_t*>(key_str.data()),
+                                       key_str.size(), date);
+        auto k_region = hmac_sha256_str(k_date.data(), 32, region);
+        auto k_service = hmac_sha256_str(k_region.data(), 32, service);
+        signing_key_ = hmac_sha256_str(k_service.data(), 32, "aws4_request");
+        signing_scope_ = scope;
+    }
 
-    auto signature = hmac_sha256_str(k_signing.data(), 32, string_to_sign);
+    auto signature = hmac_sha256_str(signing_key_.data(), 32, string_to_sign);
     std::string sig_hex = SHA256::to_hex(signature);
 
     datetime_ = datetime;  // Store for header use
 
     return "AWS4-HMAC-SHA256 Credential=" + access_key_ + "/" + scope
-         + ", SignedHeaders=host;x-amz-content-sha256;x-amz-date"
+         + ", SignedHeaders=" + signed_headers
          + ", Signature=" + sig_hex;
 }
 
@@ -133,6 +150,7 @@ bool MinioConnector::connect(const DbConnection& conn) {
     s3_host_ = conn.host + ":" + std::to_string(conn.port);
     access_key_ = conn.user;
     secret_key_ = conn.password;
+    signing_scope_.clear();  // key derived from the (new) secret
     bucket_prefix_ = conn.lab_schema.empty() ? "dedup-lab" : conn.lab_schema;
 
 #ifdef DEDUP_DRY_RUN
@@ -141,23 +159,15 @@ bool MinioConnector::connect(const DbConnection& conn) {
     return true;
 #endif
 
-    CURL* curl = curl_easy_init();
-    if (!curl) {
-        LOG_ERR("[minio] curl_easy_init failed");
-        return false;
-    }
-
-    curl_easy_setopt(curl, CURLOPT_URL, (endpoint_ + "/minio/health/live").c_str());
-    curl_easy_setopt(curl, CURLOPT_NOBODY, 1L);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 10L);
-
-    CURLcode res = curl_easy_perform(curl);
-    long http_code = 0;
-    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-    curl_easy_cleanup(curl);
+    // Also opens the keep-alive connection the first stage request reuses
+    HttpRequest req;
+    req.method = "HEAD";
+    req.url = endpoint_ + "/minio/health/live";
+    req.timeout_s = 10;
+    auto resp = HttpClient::perform(req);
 
-    if (res != CURLE_OK || http_code != 200) {
-        LOG_ERR("[minio] Health check failed: curl=%d, http=%ld", res, http_code);
+    if (resp.curl_code != 0 || resp.status != 200) {
+        LOG_ERR("[minio] Health check failed: curl=%d, http=%ld", resp.curl_code, resp.status);
         return false;
     }
 
@@ -174,28 +184,39 @@ bool MinioConnector::is_connected() const { return connected_; }
 
 // ---- S3 API helpers ----
 
-void* MinioConnector::s3_setup_request(const std::string& method, const std::string& path,
-                                        const std::string& payload_hash,
-                                        struct curl_slist** out_headers) {
-    CURL* curl = curl_easy_init();
-    if (!curl) return nullptr;
-
-    std::string url = endpoint_ + path;
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, method.c_str());
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 60L);
-
-    std::string auth = s3_sign_request(method, path, payload_hash);
+HttpHeaders MinioConnector::s3_headers(const std::string& method, const std::string& path,
+                                       const std::string& payload_hash,
+                                       const std::string& fingerprint) {
+    std::string auth = s3_sign_request(method, path, payload_hash, fingerprint);
+    HttpHeaders headers{
+        "Authorization: " + auth,
+        "x-amz-date: " + datetime_,
+        "x-amz-content-sha256: " + payload_hash,
+        "Host: " + s3_host_,
+    };
+    if (!fingerprint.empty()) headers.add("x-amz-meta-sha256: " + fingerprint);
+    return headers;
+}
 
-    struct curl_slist* headers = nullptr;
-    headers = curl_slist_append(headers, ("Authorization: " + auth).c_str());
-    headers = curl_slist_append(headers, ("x-amz-date: " + datetime_).c_str());
-    headers = curl_slist_append(headers, ("x-amz-content-sha256: " + payload_hash).c_str());
-    headers = curl_slist_append(headers, ("Host: " + s3_host_).c_str());
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+HttpResponse MinioConnector::s3_request(const std::string& method, const std::string& path,
+                                        const std::string& payload_hash,
+                                        const char* body, size_t len) {
+    HttpHeaders headers = s3_headers(method, path, payload_hash);
+    if (body) {
+        headers.add("Content-Type: application/octet-stream");
+        // No 100-continue round trip before the body (MinIO answers auth
+        // errors after the upload just as well)
+        headers.add("Expect:");
+    }
 
-    *out_headers = headers;
-    return curl;
+    HttpRequest req;
+    req.method = method;
+    req.url = endpoint_ + path;
+    req.headers = &headers;
+    req.body = body;
+    req.body_len = len;
+    req.timeout_s = 60;
+    return HttpClient::perform(req);
 }
 
 bool MinioConnector::s3_create_bucket(const std::string& bucket) {
@@ -203,116 +224,232 @@ bool MinioConnector::s3_create_bucket(const std::string& bucket) {
     LOG_DBG("[minio] DRY RUN: would create bucket %s", bucket.c_str());
     return true;
 #endif
-    std::string empty_hash = SHA256::hash_hex("", 0);
-    struct curl_slist* headers = nullptr;
-    CURL* curl = s3_setup_request("PUT", "/" + bucket, empty_hash, &headers);
-    if (!curl) return false;
-
-    CURLcode res = curl_easy_perform(curl);
-    long http_code = 0;
-    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-    curl_slist_free_all(headers);
-    curl_easy_cleanup(curl);
-
-    bool ok = res == CURLE_OK && (http_code == 200 || http_code == 409);
-    if (ok) LOG_INF("[minio] Bucket created: %s (http %ld)", bucket.c_str(), http_code);
-    else LOG_ERR("[minio] Bucket creation failed: %s (curl=%d, http=%ld)", bucket.c_str(), res, http_code);
+    auto resp = s3_request("PUT", "/" + bucket, S3_EMPTY_SHA256);
+
+    bool ok = resp.curl_code == 0 && (resp.status == 200 || resp.status == 409);
+    if (ok) LOG_INF("[minio] Bucket created: %s (http %ld)", bucket.c_str(), resp.status);
+    else LOG_ERR("[minio] Bucket creation failed: %s (curl=%d, http=%ld)",
+        bucket.c_str(), resp.curl_code, resp.status);
     return ok;
 }
 
 bool MinioConnector::s3_put_object(const std::string& bucket, const std::string& key,
-                                    const char* data, size_t len) {
+                                    const char* data, size_t len, HttpTiming* timing) {
 #ifdef DEDUP_DRY_RUN
-    (void)bucket; (void)key; (void)data; (void)len;
+    (void)bucket; (void)key; (void)data; (void)len; (void)timing;
     return true;
 #endif
-    std::string payload_hash = SHA256::hash_hex(data, len);
-    struct curl_slist* headers = nullptr;
-    CURL* curl = s3_setup_request("PUT", "/" + bucket + "/" + key, payload_hash, &headers);
-    if (!curl) return false;
-
-    headers = curl_slist_append(headers, "Content-Type: application/octet-stream");
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, data);
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, static_cast<long>(len));
-
-    CURLcode res = curl_easy_perform(curl);
-    long http_code = 0;
-    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-    curl_slist_free_all(headers);
-    curl_easy_cleanup(curl);
-
-    return res == CURLE_OK && http_code == 200;
+    std::string payload_hash = tuning_.unsigned_payload ? S3_UNSIGNED_PAYLOAD
+                                                        : SHA256::hash_hex(data, len);
+    auto resp = s3_request("PUT", "/" + bucket + "/" + key, payload_hash, data ? data : "", len);
+    if (timing) *timing = resp.timing;
+    return resp.curl_code == 0 && resp.status == 200;
 }
 
 bool MinioConnector::s3_delete_object(const std::string& bucket, const std::string& key) {
 #ifdef DEDUP_DRY_RUN
     return true;
 #endif
-    std::string empty_hash = SHA256::hash_hex("", 0);
-    struct curl_slist* headers = nullptr;
-    CURL* curl = s3_setup_request("DELETE", "/" + bucket + "/" + key, empty_hash, &headers);
-    if (!curl) return false;
-
-    CURLcode res = curl_easy_perform(curl);
-    long http_code = 0;
-    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-    curl_slist_free_all(headers);
-    curl_easy_cleanup(curl);
-
-    return res == CURLE_OK && (http_code == 200 || http_code == 204);
+    auto resp = s3_request("DELETE", "/" + bucket + "/" + key, S3_EMPTY_SHA256);
+    return resp.curl_code == 0 && (resp.status == 200 || resp.status == 204);
 }
 
 bool MinioConnector::s3_delete_bucket(const std::string& bucket) {
 #ifdef DEDUP_DRY_RUN
     return true;
 #endif
-    std::string empty_hash = SHA256::hash_hex("", 0);
-    struct curl_slist* headers = nullptr;
-    CURL* curl = s3_setup_request("DELETE", "/" + bucket, empty_hash, &headers);
-    if (!curl) return false;
+    auto resp = s3_request("DELETE", "/" + bucket, S3_EMPTY_SHA256);
+    return resp.curl_code == 0 && (resp.status == 200 || resp.status == 204);
+}
 
-    CURLcode res = curl_easy_perform(curl);
-    long http_code = 0;
-    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-    curl_slist_free_all(headers);
-    curl_easy_cleanup(curl);
+// Text of the first <tag>...</tag> in `xml` at or after `pos`
+static std::string xml_value(const std::string& xml, const std::string& tag, size_t pos = 0) {
+    const std::string open = "<" + tag + ">";
+    pos = xml.find(open, pos);
+    if (pos == std::string::npos) return "";
+    pos += open.size();
+    size_t end = xml.find("</" + tag + ">", pos);
+    return end == std::string::npos ? "" : xml.substr(pos, end - pos);
+}
+
+static std::string xml_unescape(const std::string& s) {
+    if (s.find('&') == std::string::npos) return s;
+    static const std::pair<const char*, char> ENTITIES[] = {
+        {"&amp;", '&'}, {"&lt;", '<'}, {"&gt;", '>'}, {"&quot;", '"'}, {"&apos;", '\''},
+    };
+    std::string out;
+    for (size_t i = 0; i < s.size();) {
+        bool replaced = false;
+        if (s[i] == '&') {
+            for (const auto& [ent, ch] : ENTITIES) {
+                size_t n = std::strlen(ent);
+                if (s.compare(i, n, ent) == 0) {
+                    out += ch;
+                    i += n;
+                    replaced = true;
+                    break;
+                }
+            }
+        }
+        if (!replaced) out += s[i++];
+    }
+    return out;
+}
 
-    return res == CURLE_OK && (http_code == 200 || http_code == 204);
+static std::string xml_escape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        switch (c) {
+            case '&': out += "&amp;"; break;
+            case '<': out += "&lt;"; break;
+            case '>': out += "&gt;"; break;
+            case '"': out += "&quot;"; break;
+            case '\'': out += "&apos;"; break;
+            default: out += c;
+        }
+    }
+    return out;
 }
 
-std::vector<std::string> MinioConnector::s3_list_objects(const std::string& bucket) {
-    std::vector<std::string> keys;
+bool MinioConnector::s3_list_objects(
+    const std::string& bucket,
+    const std::function<void(const std::vector<S3Object>&)>& on_page) {
 #ifdef DEDUP_DRY_RUN
-    return keys;
+    (void)bucket; (void)on_page;
+    return true;
 #endif
 
-    std::string empty_hash = SHA256::hash_hex("", 0);
-    struct curl_slist* headers = nullptr;
-    CURL* curl = s3_setup_request("GET", "/" + bucket + "?list-type=2", empty_hash, &headers);
-    if (!curl) return keys;
+    std::string token;
+    std::vector<S3Object> page;
+    do {
+        std::string path = "/" + bucket + "?list-type=2&max-keys=1000";
+        if (!token.empty()) path += "&continuation-token=" + s3_uri_encode(token);
+        auto resp = s3_request("GET", path, S3_EMPTY_SHA256);
+        if (!resp.ok()) {
+            // A missing bucket is simply empty
+            if (resp.status == 404) return true;
+            LOG_ERR("[minio] ListObjectsV2 on %s failed: %s", bucket.c_str(), resp.error().c_str());
+            return false;
+        }
+        const std::string& xml = resp.body;
+
+        page.clear();
+        size_t pos = 0;
+        while ((pos = xml.find("<Contents>", pos)) != std::string::npos) {
+            size_t end = xml.find("</Contents>", pos);
+            if (end == std::string::npos) break;
+            const std::string entry = xml.substr(pos, end - pos);
+            S3Object obj;
+            obj.key = xml_unescape(xml_value(entry, "Key"));
+            std::string size = xml_value(entry, "Size");
+            obj.size = size.empty() ? 0 : std::stoll(size);
+            page.push_back(std::move(obj));
+            pos = end;
+        }
+        if (!page.empty()) on_page(page);
 
-    std::string response;
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, curl_write_cb);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
+        token = xml_value(xml, "IsTruncated") == "true" ? xml_value(xml, "NextContinuationToken") : "";
+    } while (!token.empty());
+    return true;
+}
 
-    CURLcode res = curl_easy_perform(curl);
-    curl_slist_free_all(headers);
-    curl_easy_cleanup(curl);
+int64_t MinioConnector::s3_delete_objects(const std::string& bucket,
+                                          const std::vector<std::string>& keys) {
+    if (keys.empty()) return 0;
+#ifdef DEDUP_DRY_RUN
+    (void)bucket;
+    return static_cast<int64_t>(keys.size());
+#endif
 
-    if (res != CURLE_OK) return keys;
+    // Quiet: the response lists only the keys that could not be deleted
+    std::string xml = "<Delete><Quiet>true</Quiet>";
+    for (const auto& key : keys) xml += "<Object><Key>" + xml_escape(key) + "</Key></Object>";
+    xml += "</Delete>";
+
+    const std::string path = "/" + bucket + "?delete";
+    HttpHeaders headers = s3_headers("POST", path, tuning_.unsigned_payload
+        ? S3_UNSIGNED_PAYLOAD : SHA256::hash_hex(xml.data(), xml.size()));
+    headers.add("Content-MD5: " + MD5::hash_base64(xml.data(), xml.size()));  // required by S3
+    headers.add("Content-Type: application/xml");
+    headers.add("Expect:");
+
+    HttpRequest req;
+    req.method = "POST";
+    req.url = endpoint_ + path;
+    req.headers = &headers;
+    req.body = xml.data();
+    req.body_len = xml.size();
+    req.timeout_s = 60;
+    auto resp = HttpClient::perform(req);
+    if (!resp.ok()) {
+        LOG_ERR("[minio] DeleteObjects on %s failed: %s", bucket.c_str(), resp.error().c_str());
+        return 0;
+    }
 
-    // Simple XML parsing for <Key>...</Key> tags
+    int64_t failed = 0;
     size_t pos = 0;
-    while ((pos = response.find("<Key>", pos)) != std::string::npos) {
-        pos += 5;
-        size_t end = response.find("</Key>", pos);
-        if (end == std::string::npos) break;
-        keys.push_back(response.substr(pos, end - pos));
-        pos = end + 6;
+    while ((pos = resp.body.find("<Error>", pos)) != std::string::npos) {
+        if (failed == 0) {
+            LOG_WRN("[minio] DeleteObjects on %s: %s (%s)", bucket.c_str(),
+                xml_value(resp.body, "Key", pos).c_str(), xml_value(resp.body, "Code", pos).c_str());
+        }
+        ++failed;
+        pos += 7;
+    }
+    return static_cast<int64_t>(keys.size()) - failed;
+}
+
+int64_t MinioConnector::s3_empty_bucket(const std::string& bucket, size_t batch) {
+    int64_t deleted = 0;
+    std::vector<std::string> keys;
+    s3_list_objects(bucket, [&](const std::vector<S3Object>& page) {
+        for (const auto& obj : page) {
+            keys.push_back(obj.key);
+            if (keys.size() >= batch) {
+                deleted += s3_delete_objects(bucket, keys);
+                keys.clear();
+            }
+        }
+    });
+    deleted += s3_delete_objects(bucket, keys);
+    return deleted;
+}
+
+// ---- Part-size variants ----
+
+std::vector<std::string> MinioConnector::variants() const {
+    std::vector<std::string> names;
+    if (tuning_.multipart_threshold_mb <= 0) return names;
+    if (tuning_.part_sizes_mb.empty()) {
+        names.push_back(part_label(tuning_.part_size_mb));
+    } else {
+        for (int mb : tuning_.part_sizes_mb) names.push_back(part_label(mb));
     }
+    return names;
+}
 
-    return keys;
+bool MinioConnector::select_variant(const std::string& name) {
+    if (name.empty()) {
+        part_size_mb_ = tuning_.part_size_mb;
+        variant_selected_ = false;
+        return true;
+    }
+    std::vector<int> sizes = tuning_.part_sizes_mb;
+    if (sizes.empty()) sizes.push_back(tuning_.part_size_mb);
+    for (int mb : sizes) {
+        if (part_label(mb) != name) continue;
+        if (mb < 5) {
+            LOG_ERR("[minio] Part size %d MiB below the S3 minimum of 5 MiB", mb);
+            return false;
+        }
+        part_size_mb_ = mb;
+        variant_selected_ = true;
+        LOG_INF("[minio] Multipart part size %d MiB (files >= %d MiB)",
+            mb, tuning_.multipart_threshold_mb);
+        return true;
+    }
+    LOG_ERR("[minio] Unknown part-size variant %s", name.c_str());
+    return false;
 }
 
 // ---- Schema management ----
@@ -335,11 +472,9 @@ bool MinioConnector::drop_lab_schema(const std::string&) {
     const char* suffixes[] = {"u0", "u50", "u90", "results"};
     for (const auto& suffix : suffixes) {
         std::string bucket = bucket_prefix_ + "-" + suffix;
-        // List and delete all objects first
-        auto keys = s3_list_objects(bucket);
-        for (const auto& key : keys) {
-            s3_delete_object(bucket, key);
-        }
+        // Buckets must be empty before they can be deleted
+        int64_t deleted = s3_empty_bucket(bucket);
+        if (deleted > 0) LOG_DBG("[minio] %s: %lld objects deleted", bucket.c_str(), deleted);
         s3_delete_bucket(bucket);
     }
     return true;
@@ -369,24 +504,12 @@ MeasureResult MinioConnector::bulk_insert(const std::string& data_dir, DupGrade
     Timer timer;
     timer.start();
 
-    for (const auto& entry : fs::directory_iterator(dir)) {
-        if (!entry.is_regular_file()) continue;
-        auto fsize = entry.file_size();
-        std::ifstream f(entry.path(), std::ios::binary);
-        std::vector<char> buf(fsize);
-        f.read(buf.data(), static_cast<std::streamsize>(fsize));
-
-        std::string key = entry.path().filename().string();
-        if (s3_put_object(bucket, key, buf.data(), fsize)) {
-            result.rows_affected++;
-        }
-        result.bytes_logical += fsize;
-    }
+    upload_dir(dir, bucket, tuning_.upload_concurrency, false, result);
 
     timer.stop();
     result.duration_ns = timer.elapsed_ns();
-    LOG_INF("[minio] Bulk upload: %lld objects, %lld bytes, %lld ms",
-        result.rows_affected, result.bytes_logical, timer.elapsed_ms());
+    LOG_INF("[minio] Bulk upload: %lld objects, %lld bytes, %lld ms (%d in flight)",
+        result.rows_affected, result.bytes_logical, timer.elapsed_ms(), tuning_.upload_concurrency);
     return result;
 }
 
@@ -408,25 +531,8 @@ MeasureResult MinioConnector::perfile_insert(const std::string& data_dir, DupGra
     Timer total_timer;
     total_timer.start();
 
-    for (const auto& entry : fs::directory_iterator(dir)) {
-        if (!entry.is_regular_file()) continue;
-        auto fsize = entry.file_size();
-        std::ifstream f(entry.path(), std::ios::binary);
-        std::vector<char> buf(fsize);
-        f.read(buf.data(), static_cast<std::streamsize>(fsize));
-
-        std::string key = entry.path().filename().string();
-
-        int64_t put_ns = 0;
-        {
-            ScopedTimer st(put_ns);
-            if (s3_put_object(bucket, key, buf.data(), fsize)) {
-                result.rows_affected++;
-            }
-        }
-        result.per_file_latencies_ns.push_back(put_ns);
-        result.bytes_logical += fsize;
-    }
+    // One PUT at a time: latencies are not queued behind each other
+    upload_dir(dir, bucket, 1, true, result);
 
     total_timer.stop();
     result.duration_ns = total_timer.elapsed_ns();
@@ -435,6 +541,39 @@ MeasureResult MinioConnector::perfile_insert(const std::string& data_dir, DupGra
     return result;
 }
 
+void MinioConnector::upload_dir(const std::string& dir, const std::string& bucket,
+                                int concurrency, bool track_latency, MeasureResult& result) {
+    // Sorted: the same objects in the same order on every run
+    std::vector<fs::path> files;
+    for (const auto& entry : fs::directory_iterator(dir)) {
+        if (entry.is_regular_file()) files.push_back(entry.path());
+    }
+    std::sort(files.begin(), files.end());
+
+    S3Uploader::Options opts;
+    opts.max_inflight = concurrency;
+    opts.track_latency = track_latency;
+    opts.multipart_threshold = static_cast<int64_t>(tuning_.multipart_threshold_mb) * 1024 * 1024;
+    opts.part_size = static_cast<int64_t>(part_size_mb_) * 1024 * 1024;
+    opts.unsigned_payload = tuning_.unsigned_payload;
+
+    S3Uploader uploader(endpoint_,
+        [this](const std::string& method, const std::string& path, const std::string& payload_hash,
+               const std::string& fingerprint) {
+            return s3_headers(method, path, payload_hash, fingerprint);
+        },
+        opts, result);
+    for (const auto& f : files) {
+        uploader.add("/" + bucket + "/" + f.filename().string(), f.string());
+    }
+    uploader.finish();
+    LOG_DBG("[minio] %zu objects to %s (%lld multipart, %lld parts of %d MiB), "
+        "%lld PUTs on new connections",
+        files.size(), bucket.c_str(), static_cast<long long>(uploader.multipart_objects()),
+        static_cast<long long>(uploader.parts_uploaded()), part_size_mb_,
+        static_cast<long long>(uploader.new_connections()));
+}
+
 MeasureResult MinioConnector::perfile_delete() {
     MeasureResult result{};
     LOG_INF("[minio] Per-file delete across all lab buckets (with per-object latency)");
@@ -447,26 +586,51 @@ MeasureResult MinioConnector::perfile_delete() {
     Timer total_timer;
     total_timer.start();
 
+    // Per-object mode: one DELETE (and latency sample) per object, for
+    // Stage 3. Otherwise DeleteObjects of up to delete_batch keys, one
+    // latency sample per request.
+    const bool per_object = tuning_.delete_per_object_latency;
+    const size_t batch = static_cast<size_t>(std::clamp(tuning_.delete_batch, 1, 1000));
+
     const char* suffixes[] = {"u0", "u50", "u90"};
     for (const auto& suffix : suffixes) {
         std::string bucket = bucket_prefix_ + "-" + suffix;
-        auto keys = s3_list_objects(bucket);
-        for (const auto& key : keys) {
+        std::vector<std::string> keys;
+        bool ok = s3_list_objects(bucket, [&](const std::vector<S3Object>& page) {
+            for (const auto& obj : page) {
+                if (!per_object) {
+                    keys.push_back(obj.key);
+                    if (keys.size() < batch) continue;
+                }
+                int64_t del_ns = 0;
+                {
+                    ScopedTimer st(del_ns);
+                    if (per_object) {
+                        if (s3_delete_object(bucket, obj.key)) result.rows_affected++;
+                    } else {
+                        result.rows_affected += s3_delete_objects(bucket, keys);
+                    }
+                }
+                result.per_file_latencies_ns.push_back(del_ns);
+                keys.clear();
+            }
+        });
+        if (!keys.empty()) {
             int64_t del_ns = 0;
             {
                 ScopedTimer st(del_ns);
-                if (s3_delete_object(bucket, key)) {
-                    result.rows_affected++;
-                }
+                result.rows_affected += s3_delete_objects(bucket, keys);
             }
             result.per_file_latencies_ns.push_back(del_ns);
         }
+        if (!ok && result.error.empty()) result.error = "ListObjectsV2 failed on " + bucket;
     }
 
     total_timer.stop();
     result.duration_ns = total_timer.elapsed_ns();
-    LOG_INF("[minio] Per-file delete: %lld objects, %lld ms",
-        result.rows_affected, total_timer.elapsed_ms());
+    LOG_INF("[minio] Per-file delete: %lld objects, %lld ms (%s)",
+        result.rows_affected, total_timer.elapsed_ms(),
+        per_object ? "DELETE per object" : "batched DeleteObjects");
     return result;
 }
 
@@ -480,33 +644,15 @@ int64_t MinioConnector::get_logical_size_bytes() {
 #ifdef DEDUP_DRY_RUN
     return 0;
 #endif
-    // List all objects in lab buckets and sum sizes
-    // We use HEAD requests to get Content-Length for each object
+    // Sum of the object sizes ListObjectsV2 reports (no request per object)
     int64_t total = 0;
     const char* suffixes[] = {"u0", "u50", "u90"};
 
     for (const auto& suffix : suffixes) {
         std::string bucket = bucket_prefix_ + "-" + suffix;
-        auto keys = s3_list_objects(bucket);
-
-        for (const auto& key : keys) {
-            std::string empty_hash = SHA256::hash_hex("", 0);
-            struct curl_slist* headers = nullptr;
-            CURL* curl = s3_setup_request("HEAD", "/" + bucket + "/" + key, empty_hash, &headers);
-            if (!curl) continue;
-
-            curl_easy_setopt(curl, CURLOPT_NOBODY, 1L);
-            CURLcode res = curl_easy_perform(curl);
-
-            if (res == CURLE_OK) {
-                double cl = 0;
-                curl_easy_getinfo(curl, CURLINFO_CONTENT_LENGTH_DOWNLOAD, &cl);
-                if (cl > 0) total += static_cast<int64_t>(cl);
-            }
-
-            curl_slist_free_all(headers);
-            curl_easy_cleanup(curl);
-        }
+        s3_list_objects(bucket, [&](const std::vector<S3Object>& page) {
+            for (const auto& obj : page) total += obj.size;
+        });
     }
 
     LOG_INF("[minio] Lab bucket total logical size: %lld bytes", total);
@@ -529,10 +675,7 @@ bool MinioConnector::drop_native_schema(const std::string& schema_name, PayloadT
     auto ns = get_native_schema(type);
     std::string bucket = bucket_prefix_ + "-" + ns.table_name;
     // Delete all objects first, then the bucket
-    auto keys = s3_list_objects(bucket);
-    for (const auto& key : keys) {
-        s3_delete_object(bucket, key);
-    }
+    s3_empty_bucket(bucket);
     return s3_delete_bucket(bucket);
 }
 
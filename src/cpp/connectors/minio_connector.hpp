@@ -2,15 +2,24 @@
 // MinIO/S3 connector -- uses bucket prefix "dedup-lab-*" for isolation
 // Production buckets are NEVER touched (gitlab-*, buildsystem-*)
 // Uses libcurl + AWS Signature V4 for proper S3 authentication
+// Requests go through HttpClient, so consecutive S3 calls reuse one
+// keep-alive connection. Blob load stages upload with S3Uploader: files in
+// name order, streamed from disk, MinioTuning::upload_concurrency PUTs in
+// flight for bulk insert and one at a time for per-file insert. Large files
+// go up as multipart uploads; the part size is the connector's variant.
+// Listings are paginated ListObjectsV2 (sizes taken from the listing);
+// cleanup deletes with multi-object DeleteObjects of up to 1000 keys.
 #include "db_connector.hpp"
+#include "http_client.hpp"
+#include <array>
+#include <functional>
 #include <vector>
 
-struct curl_slist;
-
 namespace dedup {
 
 class MinioConnector : public DbConnector {
 public:
+    explicit MinioConnector(const MinioTuning& tuning = {}) : tuning_(tuning) {}
     ~MinioConnector() override { disconnect(); }
 
     bool connect(const DbConnection& conn) override;
@@ -31,6 +40,16 @@ public:
     [[nodiscard]] DbSystem system() const override { return DbSystem::MINIO; }
     [[nodiscard]] const char* system_name() const override { return "minio"; }
 
+    // Multipart part sizes (MinioTuning::part_sizes_mb, else part_size_mb),
+    // labelled e.g. "part16m"; none if multipart upload is disabled. Native
+    // objects are single in-memory PUTs, so native mode has no variants.
+    [[nodiscard]] std::vector<std::string> variants() const override;
+    [[nodiscard]] std::vector<std::string> native_variants() const override { return {}; }
+    bool select_variant(const std::string& name) override;
+    [[nodiscard]] std::string current_variant() const override {
+        return variant_selected_ ? part_label(part_size_mb_) : "";
+    }
+
 
     // Native insertion mode (Stage 1)
     bool create_native_schema(const std::string& schema_name, PayloadType type) override;
@@ -41,31 +60,67 @@ public:
     int64_t get_native_logical_size_bytes(PayloadType type) override;
 
 private:
+    MinioTuning tuning_;
+    int part_size_mb_ = tuning_.part_size_mb;  // of the selected variant
+    bool variant_selected_ = false;
     std::string endpoint_;
     std::string s3_host_;
     std::string access_key_;
     std::string secret_key_;
     std::string bucket_prefix_ = "dedup-lab";
     std::string datetime_;     // Cached for current request signing
+    std::string signing_scope_;             // date/region/service of signing_key_
+    std::array<uint8_t, 32> signing_key_{};
     bool connected_ = false;
 
-    // AWS Signature V4 signing
+    static std::string part_label(int mb) { return "part" + std::to_string(mb) + "m"; }
+
+    // AWS Signature V4 signing (path may carry a query string). A non-empty
+    // fingerprint is sent and signed as x-amz-meta-sha256.
     std::string s3_sign_request(const std::string& method, const std::string& path,
-                                 const std::string& payload_hash);
+                                 const std::string& payload_hash,
+                                 const std::string& fingerprint = "");
 
-    // Setup an authenticated S3 request with proper headers
-    // Returns CURL* as void* to avoid #include <curl/curl.h> in header
-    void* s3_setup_request(const std::string& method, const std::string& path,
+    // Authorization / x-amz-* / Host headers of a signed request
+    HttpHeaders s3_headers(const std::string& method, const std::string& path,
                            const std::string& payload_hash,
-                           struct curl_slist** out_headers);
+                           const std::string& fingerprint = "");
+
+    // Upload every file of `dir` to `bucket` (key = file name) through
+    // S3Uploader with `concurrency` PUTs in flight
+    void upload_dir(const std::string& dir, const std::string& bucket, int concurrency,
+                    bool track_latency, MeasureResult& result);
+
+    // Signed S3 request; body (not copied) is sent as application/octet-stream
+    HttpResponse s3_request(const std::string& method, const std::string& path,
+                            const std::string& payload_hash,
+                            const char* body = nullptr, size_t len = 0);
+
+    // One ListObjectsV2 entry
+    struct S3Object {
+        std::string key;
+        int64_t size = 0;
+    };
 
     // S3 API operations
     bool s3_put_object(const std::string& bucket, const std::string& key,
-                       const char* data, size_t len);
+                       const char* data, size_t len, HttpTiming* timing = nullptr);
     bool s3_delete_object(const std::string& bucket, const std::string& key);
     bool s3_create_bucket(const std::string& bucket);
     bool s3_delete_bucket(const std::string& bucket);
-    std::vector<std::string> s3_list_objects(const std::string& bucket);
+
+    // ListObjectsV2 page by page (up to 1000 keys each, continuation
+    // tokens followed); on_page sees every page as it arrives, so no full
+    // key list is held. Objects may be deleted from on_page. False if a
+    // request failed.
+    bool s3_list_objects(const std::string& bucket,
+                         const std::function<void(const std::vector<S3Object>&)>& on_page);
+    // Multi-object DeleteObjects (quiet mode) of up to 1000 keys; returns
+    // the number of keys deleted
+    int64_t s3_delete_objects(const std::string& bucket, const std::vector<std::string>& keys);
+    // Delete every object of `bucket` in DeleteObjects batches of
+    // `batch` keys; returns the number deleted
+    int64_t s3_empty_bucket(const std::string& bucket, size_t batch = 1000);
 };
 
 } // namespace dedup
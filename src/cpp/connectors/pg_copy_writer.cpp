@@ -0,0 +1,224 @@
+#include "pg_copy_writer.hpp"
+#include "../utils/logger.hpp"
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+
+namespace dedup {
+
+// 11-byte signature + int32 flags + int32 header extension length
+static constexpr char PGCOPY_SIGNATURE[] = "PGCOPY\n\377\r\n";  // + implicit '\0'
+static constexpr size_t PGCOPY_SIGNATURE_LEN = 11;
+
+bool PgCopyWriter::begin(const std::string& copy_sql) {
+    if (!conn_) {
+        fail("no connection");
+        return false;
+    }
+
+    PGresult* res = PQexec(conn_, copy_sql.c_str());
+    bool started = (PQresultStatus(res) == PGRES_COPY_IN);
+    if (!started) {
+        error_ = PQerrorMessage(conn_);
+        ok_ = false;
+    }
+    PQclear(res);
+    if (!started) return false;
+
+    in_copy_ = true;
+    buf_.clear();
+    append(PGCOPY_SIGNATURE, PGCOPY_SIGNATURE_LEN);
+    put_i32(0);  // flags: no OIDs
+    put_i32(0);  // header extension length
+    return ok_;
+}
+
+void PgCopyWriter::put_bytes(const void* data, size_t len) {
+    if (len > static_cast<size_t>(INT32_MAX)) {
+        fail("field exceeds 2 GiB COPY limit");
+        return;
+    }
+    put_i32(static_cast<int32_t>(len));
+    append(data, len);
+}
+
+void PgCopyWriter::put_jsonb(const char* json, size_t len) {
+    if (len + 1 > static_cast<size_t>(INT32_MAX)) {
+        fail("jsonb value exceeds 2 GiB COPY limit");
+        return;
+    }
+    static constexpr char JSONB_VERSION = 1;
+    put_i32(static_cast<int32_t>(len + 1));
+    append(&JSONB_VERSION, 1);
+    append(json, len);
+}
+
+bool PgCopyWriter::put_value(const ColumnValue& value, PgWire wire) {
+    return std::visit([&](const auto& v) -> bool {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<T, std::monostate>) {
+            put_null();
+            return true;
+        } else if constexpr (std::is_same_v<T, bool>) {
+            switch (wire) {
+                case PgWire::BOOL: put_bool(v); return true;
+                case PgWire::INT8: put_int64(v ? 1 : 0); return true;
+                case PgWire::INT4: put_int32(v ? 1 : 0); return true;
+                default: return false;
+            }
+        } else if constexpr (std::is_same_v<T, int64_t>) {
+            switch (wire) {
+                case PgWire::INT8:   put_int64(v); return true;
+                case PgWire::FLOAT8: put_float8(static_cast<double>(v)); return true;
+                case PgWire::INT4:
+                    if (v < INT32_MIN || v > INT32_MAX) return false;
+                    put_int32(static_cast<int32_t>(v));
+                    return true;
+                case PgWire::TEXT:
+                case PgWire::BPCHAR: put_text(std::to_string(v)); return true;
+                default: return false;
+            }
+        } else if constexpr (std::is_same_v<T, double>) {
+            switch (wire) {
+                case PgWire::FLOAT8: put_float8(v); return true;
+                default: return false;
+            }
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            switch (wire) {
+                case PgWire::TEXT:
+                case PgWire::BPCHAR:
+                case PgWire::BYTEA: put_bytes(v.data(), v.size()); return true;
+                case PgWire::JSONB: put_jsonb(v.data(), v.size()); return true;
+                default: return false;  // timestamptz/uuid text needs server parsing
+            }
+        } else if constexpr (std::is_same_v<T, std::vector<char>>) {
+            switch (wire) {
+                case PgWire::BYTEA:
+                case PgWire::TEXT:
+                case PgWire::BPCHAR: put_bytes(v.data(), v.size()); return true;
+                case PgWire::JSONB: put_jsonb(v.data(), v.size()); return true;
+                default: return false;
+            }
+        }
+        return false;
+    }, value);
+}
+
+void PgCopyWriter::put_raw(const void* data, size_t len) {
+    append(data, len);
+}
+
+void PgCopyWriter::put_i16(int16_t v) {
+    auto u = static_cast<uint16_t>(v);
+    char b[2] = {static_cast<char>(u >> 8), static_cast<char>(u)};
+    append(b, 2);
+}
+
+void PgCopyWriter::put_i32(int32_t v) {
+    auto u = static_cast<uint32_t>(v);
+    char b[4] = {static_cast<char>(u >> 24), static_cast<char>(u >> 16),
+                 static_cast<char>(u >> 8),  static_cast<char>(u)};
+    append(b, 4);
+}
+
+void PgCopyWriter::put_i64(int64_t v) {
+    auto u = static_cast<uint64_t>(v);
+    char b[8];
+    for (int i = 7; i >= 0; --i) {
+        b[i] = static_cast<char>(u & 0xFF);
+        u >>= 8;
+    }
+    append(b, 8);
+}
+
+void PgCopyWriter::append(const void* data, size_t len) {
+    if (!ok_ || len == 0) return;
+
+    if (buf_.size() + len > capacity_) {
+        if (!flush()) return;
+        // Large value: hand it to libpq as-is instead of staging a copy
+        if (len >= capacity_) {
+            send(static_cast<const char*>(data), len);
+            return;
+        }
+    }
+    const char* p = static_cast<const char*>(data);
+    buf_.insert(buf_.end(), p, p + len);
+}
+
+bool PgCopyWriter::flush() {
+    if (buf_.empty()) return ok_;
+    bool sent = send(buf_.data(), buf_.size());
+    buf_.clear();
+    return sent;
+}
+
+bool PgCopyWriter::send(const char* data, size_t len) {
+    if (!ok_) return false;
+    // PQputCopyData takes an int length -- split very large values
+    while (len > 0) {
+        size_t chunk = len > static_cast<size_t>(INT_MAX / 2) ? static_cast<size_t>(INT_MAX / 2) : len;
+        if (PQputCopyData(conn_, data, static_cast<int>(chunk)) != 1) {
+            fail("PQputCopyData failed");
+            return false;
+        }
+        data += chunk;
+        len -= chunk;
+        bytes_sent_ += static_cast<int64_t>(chunk);
+    }
+    return true;
+}
+
+bool PgCopyWriter::finish(int64_t* rows_copied) {
+    if (!in_copy_) return false;
+
+    put_i16(-1);  // trailer
+    flush();
+
+    in_copy_ = false;
+    if (PQputCopyEnd(conn_, ok_ ? nullptr : error_.c_str()) != 1) {
+        fail("PQputCopyEnd failed");
+    }
+
+    // Drain results: exactly one COMMAND_OK (or error) for the COPY statement
+    bool server_ok = false;
+    while (PGresult* res = PQgetResult(conn_)) {
+        if (PQresultStatus(res) == PGRES_COMMAND_OK) {
+            server_ok = true;
+            if (rows_copied) {
+                const char* n = PQcmdTuples(res);
+                *rows_copied = (n && n[0]) ? std::strtoll(n, nullptr, 10) : 0;
+            }
+        } else if (ok_) {
+            error_ = PQresultErrorMessage(res);
+            ok_ = false;
+        }
+        PQclear(res);
+    }
+    return ok_ && server_ok;
+}
+
+void PgCopyWriter::abort(const char* reason) {
+    if (!in_copy_) return;
+    in_copy_ = false;
+    buf_.clear();
+    PQputCopyEnd(conn_, reason);
+    while (PGresult* res = PQgetResult(conn_)) PQclear(res);
+    if (ok_) {
+        error_ = reason;
+        ok_ = false;
+    }
+}
+
+void PgCopyWriter::fail(const char* what) {
+    if (!ok_) return;
+    ok_ = false;
+    error_ = what;
+    if (conn_) {
+        const char* msg = PQerrorMessage(conn_);
+        if (msg && msg[0]) error_ += std::string(": ") + msg;
+    }
+    LOG_ERR("[COPY] %s", error_.c_str());
+}
+
+} // namespace dedup
@@ -0,0 +1,87 @@
+#pragma once
+// PostgreSQL binary COPY writer (COPY ... FROM STDIN WITH (FORMAT binary))
+// Streams the PGCOPY header, tuple frames and trailer through PQputCopyData.
+//
+// Wire format (PostgreSQL docs, "COPY -- Binary Format"):
+//   header : "PGCOPY\n\377\r\n\0" + int32 flags (0) + int32 extension length (0)
+//   tuple  : int16 field count, then per field int32 length (-1 = NULL) + bytes
+//   trailer: int16 -1
+// All integers are big-endian (network byte order).
+//
+// Small fields are coalesced into a bounded send buffer; fields larger than
+// the buffer are handed to libpq directly so payloads are never copied twice.
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <libpq-fe.h>
+#include "pg_wire.hpp"
+
+namespace dedup {
+
+class PgCopyWriter {
+public:
+    static constexpr size_t DEFAULT_BUFFER_BYTES = 1024 * 1024;  // 1 MiB
+
+    explicit PgCopyWriter(PGconn* conn, size_t buffer_bytes = DEFAULT_BUFFER_BYTES)
+        : conn_(conn), capacity_(buffer_bytes > 64 ? buffer_bytes : 64) {
+        buf_.reserve(capacity_);
+    }
+
+    // Issue the COPY statement and write the PGCOPY header.
+    // Returns false if the server did not enter COPY IN state.
+    bool begin(const std::string& copy_sql);
+
+    // Start a tuple with the given number of fields
+    void begin_tuple(int16_t nfields) { put_i16(nfields); }
+
+    // Typed field encoders (length prefix + binary value)
+    void put_null() { put_i32(-1); }
+    void put_int64(int64_t v) { put_i32(8); put_i64(v); }
+    void put_bytes(const void* data, size_t len);
+    void put_text(const std::string& s) { put_bytes(s.data(), s.size()); }
+    void put_int32(int32_t v) { put_i32(4); put_i32(v); }
+    void put_float8(double v) { put_i32(8); put_i64(static_cast<int64_t>(pg_float8_bits(v))); }
+    void put_bool(bool v) { put_i32(1); char b = v ? 1 : 0; append(&b, 1); }
+    void put_jsonb(const char* json, size_t len);
+
+    // Encode a native column value as the binary representation of `wire`.
+    // Returns false if the value cannot be represented (e.g. a text value
+    // for an int8 column) -- the tuple is then incomplete and the caller
+    // must abort() the COPY.
+    bool put_value(const ColumnValue& value, PgWire wire);
+
+    // Streamed field: write the length prefix now, then the value in
+    // arbitrary chunks via put_raw(). Caller must write exactly `len` bytes.
+    void put_field_header(int32_t len) { put_i32(len); }
+    void put_raw(const void* data, size_t len);
+
+    // Write trailer, end COPY and collect the command result.
+    // Returns false on any send or server error; rows_copied is set from CmdTuples.
+    bool finish(int64_t* rows_copied = nullptr);
+
+    // Abort an in-progress COPY (server rolls back the whole statement)
+    void abort(const char* reason);
+
+    [[nodiscard]] bool ok() const { return ok_; }
+    [[nodiscard]] const std::string& error() const { return error_; }
+    [[nodiscard]] int64_t bytes_sent() const { return bytes_sent_; }
+
+private:
+    PGconn* conn_;
+    size_t capacity_;
+    std::vector<char> buf_;
+    bool in_copy_ = false;
+    bool ok_ = true;
+    std::string error_;
+    int64_t bytes_sent_ = 0;
+
+    void put_i16(int16_t v);
+    void put_i32(int32_t v);
+    void put_i64(int64_t v);
+    void append(const void* data, size_t len);
+    bool flush();
+    bool send(const char* data, size_t len);
+    void fail(const char* what);
+};
+
+} // namespace dedup
@@ -0,0 +1,141 @@
+#include "pg_pipeline.hpp"
+#include "../utils/logger.hpp"
+#include <cstdlib>
+
+namespace dedup {
+
+bool PgPipeline::begin() {
+    if (!conn_) return false;
+    if (PQenterPipelineMode(conn_) != 1) {
+        LOG_WRN("[pipeline] PQenterPipelineMode failed: %s", PQerrorMessage(conn_));
+        return false;
+    }
+    active_ = true;
+    return true;
+}
+
+bool PgPipeline::send_params(const char* sql, int nparams,
+                             const char* const* values, const int* lengths,
+                             const int* formats) {
+    if (!wait_for_slot()) return false;
+
+    auto sent_at = std::chrono::steady_clock::now();
+    if (PQsendQueryParams(conn_, sql, nparams, nullptr,
+                          values, lengths, formats, 0) != 1) {
+        LOG_ERR("[pipeline] PQsendQueryParams failed: %s", PQerrorMessage(conn_));
+        ++errors_;
+        return false;
+    }
+    return after_send(sent_at);
+}
+
+bool PgPipeline::send_prepared(const char* stmt_name, int nparams,
+                               const char* const* values, const int* lengths,
+                               const int* formats) {
+    if (!wait_for_slot()) return false;
+
+    auto sent_at = std::chrono::steady_clock::now();
+    if (PQsendQueryPrepared(conn_, stmt_name, nparams,
+                            values, lengths, formats, 0) != 1) {
+        LOG_ERR("[pipeline] PQsendQueryPrepared failed: %s", PQerrorMessage(conn_));
+        ++errors_;
+        return false;
+    }
+    return after_send(sent_at);
+}
+
+bool PgPipeline::wait_for_slot() {
+    if (!active_) return false;
+    // Bound the number of outstanding requests
+    while (static_cast<int>(in_flight_.size()) >= depth_) {
+        if (!consume_one()) return false;
+    }
+    return true;
+}
+
+bool PgPipeline::after_send(std::chrono::steady_clock::time_point sent_at) {
+    in_flight_.push_back(sent_at);
+    // One sync point per request: ends the implicit transaction (per-request
+    // commit) and makes libpq flush the request to the server immediately.
+    if (PQpipelineSync(conn_) != 1) {
+        LOG_ERR("[pipeline] PQpipelineSync failed: %s", PQerrorMessage(conn_));
+        ++errors_;
+        return false;
+    }
+    return drain_ready();
+}
+
+bool PgPipeline::drain_ready() {
+    while (!in_flight_.empty()) {
+        if (PQconsumeInput(conn_) != 1) {
+            LOG_ERR("[pipeline] Connection lost with %zu requests in flight: %s",
+                in_flight_.size(), PQerrorMessage(conn_));
+            errors_ += static_cast<int64_t>(in_flight_.size());
+            in_flight_.clear();
+            return false;
+        }
+        if (PQisBusy(conn_)) break;
+        if (!consume_one()) return false;
+    }
+    return true;
+}
+
+bool PgPipeline::consume_one() {
+    if (in_flight_.empty()) return true;
+
+    bool have_status = false;
+    bool ok = false;
+    int64_t latency_ns = 0;
+
+    // Sequence per request: <result> NULL <PIPELINE_SYNC>
+    for (;;) {
+        PGresult* res = PQgetResult(conn_);
+        if (!res) {
+            if (PQstatus(conn_) != CONNECTION_OK) {
+                LOG_ERR("[pipeline] Connection lost with %zu requests in flight",
+                    in_flight_.size());
+                errors_ += static_cast<int64_t>(in_flight_.size());
+                in_flight_.clear();
+                return false;
+            }
+            continue;
+        }
+
+        ExecStatusType st = PQresultStatus(res);
+        if (st == PGRES_PIPELINE_SYNC) {
+            PQclear(res);
+            break;
+        }
+        if (!have_status) {
+            have_status = true;
+            latency_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - in_flight_.front()).count();
+            ok = (st == PGRES_COMMAND_OK || st == PGRES_TUPLES_OK);
+            if (ok) {
+                const char* n = PQcmdTuples(res);
+                result_.rows_affected += (n && n[0]) ? std::strtoll(n, nullptr, 10) : 1;
+            } else {
+                LOG_ERR("[pipeline] Request failed: %s", PQresultErrorMessage(res));
+            }
+        }
+        PQclear(res);
+    }
+
+    in_flight_.pop_front();
+    if (!ok) ++errors_;
+    result_.per_file_latencies_ns.push_back(latency_ns);
+    return true;
+}
+
+void PgPipeline::finish() {
+    if (!active_) return;
+    while (!in_flight_.empty()) {
+        if (!consume_one()) break;
+    }
+    if (PQexitPipelineMode(conn_) != 1) {
+        LOG_WRN("[pipeline] PQexitPipelineMode failed: %s", PQerrorMessage(conn_));
+    }
+    active_ = false;
+}
+
+} // namespace dedup
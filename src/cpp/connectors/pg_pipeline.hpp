@@ -0,0 +1,66 @@
+#pragma once
+// libpq pipeline mode (PostgreSQL 14+ client) for per-file operations
+//
+// Keeps up to `depth` requests in flight on one connection. Every request is
+// followed by its own sync point, so each statement still commits on its own
+// (same autocommit semantics as the synchronous path) and an error only
+// affects that one request.
+//
+// Latency of request i = time from its send to the arrival of its own result,
+// i.e. it includes queueing behind the i-1 earlier in-flight requests.
+// Results that have already arrived are read after every send, without
+// blocking, so a latency does not grow with the client work done while the
+// window fills up.
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <libpq-fe.h>
+#include "db_connector.hpp"
+
+namespace dedup {
+
+class PgPipeline {
+public:
+    // Results (rows_affected, per_file_latencies_ns) are accumulated into `result`
+    PgPipeline(PGconn* conn, int depth, MeasureResult& result)
+        : conn_(conn), depth_(depth > 1 ? depth : 1), result_(result) {}
+
+    ~PgPipeline() { finish(); }
+
+    PgPipeline(const PgPipeline&) = delete;
+    PgPipeline& operator=(const PgPipeline&) = delete;
+
+    // Enter pipeline mode. Returns false if libpq/server refuse it.
+    bool begin();
+
+    // Queue one parameterized statement; blocks on the oldest request
+    // while `depth` requests are already in flight.
+    bool send_params(const char* sql, int nparams,
+                     const char* const* values, const int* lengths, const int* formats);
+
+    // Same for a statement prepared earlier with PQprepare
+    bool send_prepared(const char* stmt_name, int nparams,
+                       const char* const* values, const int* lengths, const int* formats);
+
+    // Wait for all in-flight requests, then leave pipeline mode
+    void finish();
+
+    [[nodiscard]] int64_t errors() const { return errors_; }
+    [[nodiscard]] size_t in_flight() const { return in_flight_.size(); }
+
+private:
+    PGconn* conn_;
+    int depth_;
+    MeasureResult& result_;
+    bool active_ = false;
+    int64_t errors_ = 0;
+    std::deque<std::chrono::steady_clock::time_point> in_flight_;
+
+    bool wait_for_slot();
+    bool after_send(std::chrono::steady_clock::time_point sent_at);
+    bool consume_one();
+    // Consume the results that are complete in the input buffer; never blocks
+    bool drain_ready();
+};
+
+} // namespace dedup
@@ -0,0 +1,75 @@
+#pragma once
+// PostgreSQL wire types for native ColumnDef type hints
+// Shared by prepared-statement binding (binary parameters) and COPY BINARY.
+//
+// Binary representations (network byte order):
+//   int8 / int4  : two's complement, 8 / 4 bytes
+//   float8       : IEEE 754 bits, 8 bytes
+//   bool         : 1 byte (0/1)
+//   text, bpchar : raw UTF-8 bytes
+//   bytea        : raw bytes
+//   jsonb        : version byte 0x01 + JSON text
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <libpq-fe.h>
+#include "../experiment/native_record.hpp"
+
+namespace dedup {
+
+enum class PgWire { INT8, INT4, FLOAT8, BOOL, TEXT, BPCHAR, BYTEA, JSONB, TIMESTAMPTZ, UUID, UNKNOWN };
+
+// Built-in type OIDs (src/include/catalog/pg_type.dat) -- stable across versions
+inline Oid pg_wire_oid(PgWire w) {
+    switch (w) {
+        case PgWire::INT8:        return 20;
+        case PgWire::INT4:        return 23;
+        case PgWire::FLOAT8:      return 701;
+        case PgWire::BOOL:        return 16;
+        case PgWire::TEXT:        return 25;
+        case PgWire::BPCHAR:      return 1042;
+        case PgWire::BYTEA:       return 17;
+        case PgWire::JSONB:       return 3802;
+        case PgWire::TIMESTAMPTZ: return 1184;
+        case PgWire::UUID:        return 2950;
+        case PgWire::UNKNOWN:     return 0;  // let the server infer
+    }
+    return 0;
+}
+
+inline PgWire pg_wire_for(const ColumnDef& col) {
+    const std::string& t = col.type_hint;
+    if (t == "SERIAL" || t == "BIGINT") return PgWire::INT8;
+    if (t == "INT")         return PgWire::INT4;
+    if (t == "DOUBLE")      return PgWire::FLOAT8;
+    if (t == "BOOLEAN")     return PgWire::BOOL;
+    if (t == "TEXT")        return PgWire::TEXT;
+    if (t == "BYTEA")       return PgWire::BYTEA;
+    if (t == "JSONB")       return PgWire::JSONB;
+    if (t == "TIMESTAMPTZ") return PgWire::TIMESTAMPTZ;
+    if (t == "UUID")        return PgWire::UUID;
+    if (t.compare(0, 4, "CHAR") == 0) return PgWire::BPCHAR;
+    return PgWire::UNKNOWN;
+}
+
+inline void pg_store_be32(char* out, uint32_t v) {
+    out[0] = static_cast<char>(v >> 24);
+    out[1] = static_cast<char>(v >> 16);
+    out[2] = static_cast<char>(v >> 8);
+    out[3] = static_cast<char>(v);
+}
+
+inline void pg_store_be64(char* out, uint64_t v) {
+    for (int i = 7; i >= 0; --i) {
+        out[i] = static_cast<char>(v & 0xFF);
+        v >>= 8;
+    }
+}
+
+inline uint64_t pg_float8_bits(double d) {
+    uint64_t bits;
+    std::memcpy(&bits, &d, sizeof(bits));
+    return bits;
+}
+
+} // namespace dedup
@@ -1,17 +1,26 @@
 #include "postgres_connector.hpp"
+#include "pg_copy_writer.hpp"
+#include "pg_pipeline.hpp"
+#include "pg_wire.hpp"
+#include "crdb_client.hpp"
 #include "../utils/timer.hpp"
 #include "../utils/logger.hpp"
 #include "../utils/sha256.hpp"
+#include <algorithm>
+#include <climits>
 #include <cstring>
 #include "../experiment/native_record.hpp"
 #include <filesystem>
 #include <fstream>
+#include <thread>
 
 namespace dedup {
 namespace fs = std::filesystem;
 
 bool PostgresConnector::connect(const DbConnection& conn) {
     schema_ = conn.lab_schema;
+    conn_info_ = conn;
+    has_conn_info_ = true;
 
     // Build connection string
     // For CockroachDB: same PG wire protocol, works with libpq
@@ -43,6 +52,9 @@ bool PostgresConnector::connect(const DbConnection& conn) {
 }
 
 void PostgresConnector::disconnect() {
+    workers_.clear();   // closes worker connections
+    gateways_.clear();
+    prepared_.clear();  // server-side statements die with the session
     if (conn_) {
         PQfinish(conn_);
         conn_ = nullptr;
@@ -59,6 +71,10 @@ bool PostgresConnector::is_connected() const {
 bool PostgresConnector::reconnect(const DbConnection& conn) {
     if (conn_) {
         // PQreset reuses existing connection parameters -- faster than full reconnect
+        // (new session: previously prepared statements are gone)
+        prepared_.clear();
+        workers_.clear();  // reopened lazily by the next parallel stage
+        gateways_.clear();
         PQreset(conn_);
         if (PQstatus(conn_) == CONNECTION_OK) {
             LOG_INF("[%s] PQreset successful (server %s)",
@@ -73,6 +89,121 @@ bool PostgresConnector::reconnect(const DbConnection& conn) {
     return connect(conn);
 }
 
+// --- Parallel workers (PostgresTuning::parallelism) ---
+
+int PostgresConnector::open_workers(int wanted) {
+    if (wanted < 1) wanted = 1;
+    if (!conn_ || !has_conn_info_) return 1;
+
+    PostgresTuning worker_tuning = tuning_;
+    worker_tuning.parallelism = 1;
+
+    // CockroachDB: spread workers round-robin over every live gateway node
+    if (system_ == DbSystem::COCKROACHDB && tuning_.crdb_spread_gateways &&
+        wanted > 1 && gateways_.empty()) {
+        gateways_ = crdb_discover_gateways(conn_);
+        LOG_INF("[%s] Discovered %zu live gateway nodes", system_name(), gateways_.size());
+    }
+
+    while (static_cast<int>(workers_.size()) + 1 < wanted) {
+        auto w = std::make_unique<PostgresConnector>(system_, worker_tuning);
+        DbConnection wc = conn_info_;
+        if (!gateways_.empty()) {
+            const auto& gw = gateways_[workers_.size() % gateways_.size()];
+            wc.host = gw.host;
+            wc.port = gw.port;
+            LOG_DBG("[%s] Worker %zu -> n%lld %s:%u", system_name(), workers_.size() + 1,
+                static_cast<long long>(gw.node_id), gw.host.c_str(), gw.port);
+        }
+        // Advertised address unreachable from here: fall back to the service
+        if (!w->connect(wc) && !gateways_.empty()) w->connect(conn_info_);
+        if (!w->conn_) {
+            LOG_WRN("[%s] Could not open worker connection %zu -- running with %zu",
+                system_name(), workers_.size() + 1, workers_.size() + 1);
+            break;
+        }
+        workers_.push_back(std::move(w));
+    }
+    for (auto& w : workers_) w->schema_ = schema_;
+
+    int n = std::min(wanted, static_cast<int>(workers_.size()) + 1);
+    if (n > 1) LOG_INF("[%s] Parallel mode: %d connections", system_name(), n);
+    return n;
+}
+
+PostgresConnector& PostgresConnector::worker(int idx) {
+    return idx == 0 ? *this : *workers_[static_cast<size_t>(idx - 1)];
+}
+
+MeasureResult PostgresConnector::run_partitioned(int n, const PartitionFn& fn) {
+    MeasureResult total{};
+    if (n <= 1) {
+        fn(*this, 0, 1, total);
+        return total;
+    }
+
+    // One thread per connection; every worker writes only its own result
+    std::vector<MeasureResult> parts(static_cast<size_t>(n));
+    std::vector<std::thread> threads;
+    threads.reserve(static_cast<size_t>(n));
+    for (int i = 0; i < n; ++i) {
+        threads.emplace_back([&, i] {
+            int64_t worker_ns = 0;
+            {
+                ScopedTimer st(worker_ns);
+                fn(worker(i), i, n, parts[static_cast<size_t>(i)]);
+            }
+            parts[static_cast<size_t>(i)].duration_ns = worker_ns;
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    for (auto& part : parts) {
+        total.rows_affected += part.rows_affected;
+        total.bytes_logical += part.bytes_logical;
+        total.txn_retries += part.txn_retries;
+        total.per_file_latencies_ns.insert(total.per_file_latencies_ns.end(),
+            part.per_file_latencies_ns.begin(), part.per_file_latencies_ns.end());
+        total.partition_durations_ns.insert(total.partition_durations_ns.end(),
+            part.partition_durations_ns.begin(), part.partition_durations_ns.end());
+        total.worker_durations_ns.push_back(part.duration_ns);
+        if (!part.error.empty()) {
+            if (!total.error.empty()) total.error += "; ";
+            total.error += part.error;
+        }
+    }
+    return total;
+}
+
+std::vector<fs::path> PostgresConnector::list_data_files(const std::string& dir) {
+    std::vector<fs::path> files;
+    for (const auto& entry : fs::directory_iterator(dir)) {
+        if (entry.is_regular_file()) files.push_back(entry.path());
+    }
+    std::sort(files.begin(), files.end());  // deterministic partitioning
+    return files;
+}
+
+std::vector<fs::path> PostgresConnector::stride_partition(const std::vector<fs::path>& all,
+                                                          int idx, int n) {
+    // Round-robin keeps large and small files spread evenly across workers
+    if (n <= 1) return all;
+    std::vector<fs::path> part;
+    for (size_t i = static_cast<size_t>(idx); i < all.size(); i += static_cast<size_t>(n)) {
+        part.push_back(all[i]);
+    }
+    return part;
+}
+
+std::span<const NativeRecord> PostgresConnector::range_partition(
+    const std::vector<NativeRecord>& all, int idx, int n) {
+    // Contiguous slices: no record copies, same split for every run
+    const size_t len = all.size();
+    const size_t begin = len * static_cast<size_t>(idx) / static_cast<size_t>(n);
+    const size_t end = len * static_cast<size_t>(idx + 1) / static_cast<size_t>(n);
+    return std::span<const NativeRecord>(all.data() + begin, end - begin);
+}
+
 bool PostgresConnector::exec(const char* sql) {
 #ifdef DEDUP_DRY_RUN
     LOG_DBG("[%s] DRY RUN SQL: %s", system_name(), sql);
@@ -107,9 +238,10 @@ PGresult* PostgresConnector::query(const char* sql) {
 // --- Lab schema management (CRITICAL: production safety!) ---
 
 bool PostgresConnector::create_lab_schema(const std::string& schema_name) {
+    size_cache_.invalidate();
     LOG_INF("[%s] Creating lab schema: %s", system_name(), schema_name.c_str());
 
-    char sql[256];
+    char sql[512];
     if (system_ == DbSystem::COCKROACHDB) {
         // CockroachDB: use CREATE DATABASE instead of schema
         std::snprintf(sql, sizeof(sql),
@@ -132,6 +264,20 @@ bool PostgresConnector::create_lab_schema(const std::string& schema_name) {
             "  payload BYTEA NOT NULL,"
             "  inserted_at TIMESTAMPTZ DEFAULT now()"
             ")", schema_name.c_str());
+    } else if (partitioned()) {
+        // The primary key of a partitioned table must contain the partition key
+        const bool by_sha = (tuning_.partition_key == "sha256");
+        std::snprintf(sql, sizeof(sql),
+            "CREATE TABLE IF NOT EXISTS %s.files ("
+            "  id UUID NOT NULL DEFAULT gen_random_uuid(),"
+            "  mime TEXT NOT NULL,"
+            "  size_bytes BIGINT NOT NULL,"
+            "  sha256 BYTEA NOT NULL,"
+            "  payload BYTEA NOT NULL,"
+            "  inserted_at TIMESTAMPTZ DEFAULT now(),"
+            "  PRIMARY KEY (%s)"
+            ") PARTITION BY HASH (%s)", schema_name.c_str(),
+            by_sha ? "id, sha256" : "id", by_sha ? "sha256" : "id");
     } else {
         std::snprintf(sql, sizeof(sql),
             "CREATE TABLE IF NOT EXISTS %s.files ("
@@ -143,13 +289,146 @@ bool PostgresConnector::create_lab_schema(const std::string& schema_name) {
             "  inserted_at TIMESTAMPTZ DEFAULT now()"
             ")", schema_name.c_str());
     }
-    return exec(sql);
+    if (!exec(sql)) return false;
+    if (!create_hash_partitions(schema_name + ".files")) return false;
+
+    // sha256/mime stay far below the TOAST threshold; only payload matters
+    return apply_storage_variant(schema_name + ".files", {"payload"});
+}
+
+// --- Hash-partitioned layout (PostgresTuning::hash_partitions) ---
+
+bool PostgresConnector::partitioned() const {
+    return system_ == DbSystem::POSTGRESQL && tuning_.hash_partitions > 0;
+}
+
+bool PostgresConnector::create_hash_partitions(const std::string& table) {
+    if (!partitioned()) return true;
+    const int n = tuning_.hash_partitions;
+    for (int i = 0; i < n; ++i) {
+        std::string sql = "CREATE TABLE IF NOT EXISTS " + table + "_p" + std::to_string(i) +
+            " PARTITION OF " + table + " FOR VALUES WITH (MODULUS " + std::to_string(n) +
+            ", REMAINDER " + std::to_string(i) + ")";
+        if (!exec(sql.c_str())) return false;
+    }
+    LOG_INF("[%s] %s: %d hash partitions", system_name(), table.c_str(), n);
+    return true;
+}
+
+std::vector<std::string> PostgresConnector::list_partitions() {
+    std::vector<std::string> parts;
+    std::string sql =
+        "SELECT format('%I.%I', n.nspname, c.relname) FROM pg_inherits i "
+        "JOIN pg_class c ON c.oid = i.inhrelid "
+        "JOIN pg_namespace n ON n.oid = c.relnamespace "
+        "WHERE n.nspname = '" + schema_ + "' AND c.relkind = 'r' ORDER BY 1";
+    PGresult* res = query(sql.c_str());
+    if (!res) return parts;
+    for (int i = 0; i < PQntuples(res); ++i) parts.emplace_back(PQgetvalue(res, i, 0));
+    PQclear(res);
+    return parts;
+}
+
+std::string PostgresConnector::relation_size_sql(const std::string& table) const {
+    // A partitioned parent has no storage of its own: sum its leaves
+    if (partitioned()) {
+        return "SELECT COALESCE(SUM(pg_total_relation_size(relid)), 0) "
+               "FROM pg_partition_tree('" + table + "')";
+    }
+    return "SELECT pg_total_relation_size('" + table + "')";
+}
+
+// --- Storage-strategy variants ---
+
+std::vector<std::string> PostgresConnector::variants() const {
+    std::vector<std::string> names;
+    if (system_ == DbSystem::COCKROACHDB) return names;  // no TOAST / fillfactor
+    for (const auto& v : tuning_.storage_variants) names.push_back(v.label());
+    return names;
+}
+
+bool PostgresConnector::select_variant(const std::string& name) {
+    if (name.empty()) {
+        variant_ = nullptr;
+        return true;
+    }
+    for (const auto& v : tuning_.storage_variants) {
+        if (v.label() != name) continue;
+
+        // Values are spliced into DDL: accept only the documented keywords
+        static const char* const STORAGE[] = {"", "PLAIN", "MAIN", "EXTERNAL", "EXTENDED"};
+        static const char* const COMPRESSION[] = {"", "pglz", "lz4"};
+        bool storage_ok = false, compression_ok = false;
+        for (const char* s : STORAGE) storage_ok |= (v.storage == s);
+        for (const char* c : COMPRESSION) compression_ok |= (v.compression == c);
+        if (!storage_ok || !compression_ok ||
+            (v.fillfactor != 0 && (v.fillfactor < 10 || v.fillfactor > 100))) {
+            LOG_ERR("[%s] Invalid storage variant %s (storage=%s compression=%s fillfactor=%d)",
+                system_name(), name.c_str(), v.storage.c_str(), v.compression.c_str(), v.fillfactor);
+            return false;
+        }
+
+        variant_ = &v;
+        LOG_INF("[%s] Storage variant %s: storage=%s compression=%s fillfactor=%d",
+            system_name(), name.c_str(),
+            v.storage.empty() ? "default" : v.storage.c_str(),
+            v.compression.empty() ? "default" : v.compression.c_str(), v.fillfactor);
+        return true;
+    }
+    LOG_ERR("[%s] Unknown storage variant %s", system_name(), name.c_str());
+    return false;
+}
+
+bool PostgresConnector::apply_storage_variant(const std::string& table,
+                                              const std::vector<std::string>& columns) {
+    if (!variant_ || system_ == DbSystem::COCKROACHDB) return true;
+
+    // One ALTER TABLE: the table is still empty, so nothing is rewritten
+    std::string actions;
+    auto add = [&](const std::string& action) {
+        if (!actions.empty()) actions += ", ";
+        actions += action;
+    };
+    for (const auto& col : columns) {
+        if (!variant_->storage.empty())
+            add("ALTER COLUMN " + col + " SET STORAGE " + variant_->storage);
+        if (!variant_->compression.empty())
+            add("ALTER COLUMN " + col + " SET COMPRESSION " + variant_->compression);
+    }
+    // Storage parameters are per heap: on a partitioned table set them on
+    // each partition (SET STORAGE / SET COMPRESSION recurse on their own)
+    const std::string fillfactor = variant_->fillfactor > 0
+        ? "SET (fillfactor = " + std::to_string(variant_->fillfactor) + ")" : "";
+    if (!fillfactor.empty() && !partitioned()) add(fillfactor);
+
+    if (!actions.empty()) {
+        std::string sql = "ALTER TABLE " + table + " " + actions;
+        LOG_DBG("[%s] %s", system_name(), sql.c_str());
+        if (!exec(sql.c_str())) return false;
+    }
+    if (!fillfactor.empty() && partitioned()) {
+        for (int i = 0; i < tuning_.hash_partitions; ++i) {
+            std::string sql = "ALTER TABLE " + table + "_p" + std::to_string(i) + " " + fillfactor;
+            if (!exec(sql.c_str())) return false;
+        }
+    }
+    return true;
 }
 
 bool PostgresConnector::drop_lab_schema(const std::string& schema_name) {
+    size_cache_.invalidate();
     LOG_WRN("[%s] DROPPING lab schema: %s (all lab data will be lost!)",
         system_name(), schema_name.c_str());
 
+    // Cached INSERT statements reference tables inside the schema
+    for (int i = 0; i <= static_cast<int>(workers_.size()); ++i) {
+        PostgresConnector& pg = worker(i);
+        if (!pg.prepared_.empty()) {
+            pg.exec("DEALLOCATE ALL");
+            pg.prepared_.clear();
+        }
+    }
+
     char sql[256];
     if (system_ == DbSystem::COCKROACHDB) {
         std::snprintf(sql, sizeof(sql),
@@ -169,6 +448,7 @@ bool PostgresConnector::reset_lab_schema(const std::string& schema_name) {
 // --- Data operations ---
 
 MeasureResult PostgresConnector::bulk_insert(const std::string& data_dir, DupGrade grade) {
+    size_cache_.invalidate();
     MeasureResult result{};
     const std::string dir = data_dir + "/" + dup_grade_str(grade);
 
@@ -181,16 +461,114 @@ MeasureResult PostgresConnector::bulk_insert(const std::string& data_dir, DupGra
     return result;
 #endif
 
+    const auto files = list_data_files(dir);
+    const int workers = open_workers(tuning_.parallelism);
+
     Timer timer;
     timer.start();
 
-    // Use COPY for maximum PostgreSQL bulk-load performance
+    // Use binary COPY for maximum PostgreSQL bulk-load performance.
+    // Fall back to row-wise INSERT in one transaction if the server refuses
+    // COPY BINARY (older CockroachDB releases). CockroachDB uses batched
+    // INSERT transactions so contention retries are visible and counted.
+    result = run_partitioned(workers,
+        [&](PostgresConnector& w, int idx, int n, MeasureResult& r) {
+            auto part = stride_partition(files, idx, n);
+            if (w.use_crdb_batches()) {
+                w.crdb_insert_files(part, r);
+            } else if (!w.bulk_copy_files(part, r)) {
+                LOG_WRN("[%s] COPY BINARY unavailable -- falling back to row-wise INSERT",
+                    w.system_name());
+                r = MeasureResult{};
+                w.bulk_insert_rowwise(part, r);
+            }
+        });
+
+    timer.stop();
+    result.duration_ns = timer.elapsed_ns();
+
+    LOG_INF("[%s] Bulk insert complete: %lld rows, %lld bytes, %lld ms",
+        system_name(), result.rows_affected, result.bytes_logical, timer.elapsed_ms());
+
+    return result;
+}
+
+bool PostgresConnector::bulk_copy_files(const std::vector<fs::path>& files,
+                                        MeasureResult& result) {
+    // payload precedes sha256 in the column list so each file is streamed
+    // once: hashed chunk by chunk while it is sent, fingerprint written last.
     char copy_sql[512];
     std::snprintf(copy_sql, sizeof(copy_sql),
-        "COPY %s.files (mime, size_bytes, sha256, payload) FROM STDIN WITH (FORMAT binary)",
+        "COPY %s.files (mime, size_bytes, payload, sha256) FROM STDIN WITH (FORMAT binary)",
         schema_.c_str());
 
-    // For each file in the data directory, read and insert via parameterized query
+    PgCopyWriter copy(conn_, static_cast<size_t>(tuning_.copy_buffer_bytes));
+    if (!copy.begin(copy_sql)) {
+        LOG_WRN("[%s] COPY start failed: %s", system_name(), copy.error().c_str());
+        return false;
+    }
+
+    static const std::string mime = "application/octet-stream";
+    std::vector<char> chunk(COPY_READ_CHUNK_BYTES);
+    int64_t tuples = 0;
+
+    for (const auto& path : files) {
+        std::error_code ec;
+        auto fsize = fs::file_size(path, ec);
+        std::ifstream f(path, std::ios::binary);
+        if (ec || !f.is_open() || fsize > static_cast<uintmax_t>(INT32_MAX)) {
+            LOG_ERR("[%s] Skipping unreadable/oversized file %s",
+                system_name(), path.string().c_str());
+            continue;
+        }
+
+        copy.begin_tuple(4);
+        copy.put_text(mime);
+        copy.put_int64(static_cast<int64_t>(fsize));
+        copy.put_field_header(static_cast<int32_t>(fsize));
+
+        SHA256 hasher;
+        uintmax_t remaining = fsize;
+        while (remaining > 0 && copy.ok()) {
+            auto want = static_cast<std::streamsize>(
+                std::min<uintmax_t>(remaining, chunk.size()));
+            f.read(chunk.data(), want);
+            if (f.gcount() != want) break;
+            hasher.update(chunk.data(), static_cast<size_t>(want));
+            copy.put_raw(chunk.data(), static_cast<size_t>(want));
+            remaining -= static_cast<uintmax_t>(want);
+        }
+        if (!copy.ok()) break;
+        if (remaining > 0) {
+            // Length prefix already sent -- the tuple cannot be completed
+            copy.abort("file changed size during COPY");
+            result.error = "COPY aborted: short read on " + path.string();
+            LOG_ERR("[%s] %s", system_name(), result.error.c_str());
+            return true;
+        }
+
+        // Stored as hex text bytes, identical to the per-file INSERT path
+        copy.put_text(SHA256::to_hex(hasher.finalize()));
+        ++tuples;
+        result.bytes_logical += static_cast<int64_t>(fsize);
+    }
+
+    int64_t copied = 0;
+    if (copy.finish(&copied)) {
+        result.rows_affected = copied;
+    } else {
+        result.error = "COPY failed: " + copy.error();
+        LOG_ERR("[%s] %s", system_name(), result.error.c_str());
+    }
+    LOG_DBG("[%s] COPY streamed %lld tuples, %lld wire bytes",
+        system_name(), static_cast<long long>(tuples),
+        static_cast<long long>(copy.bytes_sent()));
+    return true;
+}
+
+void PostgresConnector::bulk_insert_rowwise(const std::vector<fs::path>& files,
+                                            MeasureResult& result) {
+    // For each file, read and insert via parameterized query
     exec("BEGIN");
 
     char insert_sql[512];
@@ -198,11 +576,11 @@ MeasureResult PostgresConnector::bulk_insert(const std::string& data_dir, DupGra
         "INSERT INTO %s.files (mime, size_bytes, sha256, payload) "
         "VALUES ($1, $2, $3, $4)", schema_.c_str());
 
-    for (const auto& entry : fs::directory_iterator(dir)) {
-        if (!entry.is_regular_file()) continue;
-
-        auto fsize = entry.file_size();
-        std::ifstream f(entry.path(), std::ios::binary);
+    for (const auto& path : files) {
+        std::error_code ec;
+        auto fsize = fs::file_size(path, ec);
+        if (ec) continue;
+        std::ifstream f(path, std::ios::binary);
         std::vector<char> buf(fsize);
         f.read(buf.data(), static_cast<std::streamsize>(fsize));
 
@@ -233,17 +611,89 @@ MeasureResult PostgresConnector::bulk_insert(const std::string& data_dir, DupGra
     }
 
     exec("COMMIT");
+}
 
-    timer.stop();
-    result.duration_ns = timer.elapsed_ns();
+void PostgresConnector::crdb_insert_files(const std::vector<fs::path>& files,
+                                          MeasureResult& result) {
+    // 4 parameters per row; stay below the 65535 bind-parameter limit
+    const size_t max_rows = static_cast<size_t>(std::clamp(tuning_.crdb_batch_rows, 1, 65535 / 4));
+
+    struct FileRow {
+        std::string size;
+        std::string sha256_hex;
+        std::vector<char> payload;
+    };
+    std::vector<FileRow> batch;
+    batch.reserve(max_rows);
+    int64_t batch_bytes = 0;
+
+    std::string sql;
+    std::vector<const char*> values;
+    std::vector<int> lengths, formats;
+
+    auto flush = [&]() {
+        if (batch.empty()) return;
+
+        sql = "INSERT INTO " + schema_ + ".files (mime, size_bytes, sha256, payload) VALUES ";
+        values.clear();
+        lengths.clear();
+        formats.clear();
+        for (size_t i = 0; i < batch.size(); ++i) {
+            const size_t p = i * 4;
+            if (i > 0) sql += ", ";
+            sql += "($" + std::to_string(p + 1) + ", $" + std::to_string(p + 2) +
+                   ", $" + std::to_string(p + 3) + ", $" + std::to_string(p + 4) + ")";
+            values.insert(values.end(), {"application/octet-stream",
+                batch[i].size.c_str(), batch[i].sha256_hex.c_str(), batch[i].payload.data()});
+            lengths.insert(lengths.end(), {0, 0, 0, static_cast<int>(batch[i].payload.size())});
+            formats.insert(formats.end(), {0, 0, 0, 1});  // payload is binary
+        }
 
-    LOG_INF("[%s] Bulk insert complete: %lld rows, %lld bytes, %lld ms",
-        system_name(), result.rows_affected, result.bytes_logical, timer.elapsed_ms());
+        int64_t rows = 0;
+        std::string err;
+        bool ok = crdb_retry_txn(conn_, tuning_.crdb_max_retries, [&] {
+            return PQexecParams(conn_, sql.c_str(), static_cast<int>(values.size()), nullptr,
+                values.data(), lengths.data(), formats.data(), 0);
+        }, result.txn_retries, rows, err);
+
+        if (ok) {
+            result.rows_affected += rows;
+        } else {
+            LOG_ERR("[%s] Batched INSERT of %zu rows failed: %s",
+                system_name(), batch.size(), err.c_str());
+            result.error = err;
+        }
+        batch.clear();
+        batch_bytes = 0;
+    };
+
+    for (const auto& path : files) {
+        std::error_code ec;
+        auto fsize = fs::file_size(path, ec);
+        if (ec || fsize > static_cast<uintmax_t>(INT32_MAX)) continue;
+
+        FileRow row;
+        row.payload.resize(fsize);
+        std::ifstream f(path, std::ios::binary);
+        f.read(row.payload.data(), static_cast<std::streamsize>(fsize));
+        row.sha256_hex = SHA256::hash_hex(row.payload.data(), fsize);
+        row.size = std::to_string(fsize);
+        batch.push_back(std::move(row));
+
+        result.bytes_logical += static_cast<int64_t>(fsize);
+        batch_bytes += static_cast<int64_t>(fsize);
+        if (batch.size() >= max_rows || batch_bytes >= tuning_.crdb_batch_bytes) flush();
+    }
+    flush();
 
-    return result;
+    if (result.txn_retries > 0) {
+        LOG_INF("[%s] Batched INSERT: %lld transaction retries",
+            system_name(), static_cast<long long>(result.txn_retries));
+    }
 }
 
 MeasureResult PostgresConnector::perfile_insert(const std::string& data_dir, DupGrade grade) {
+    size_cache_.invalidate();
     MeasureResult result{};
     const std::string dir = data_dir + "/" + dup_grade_str(grade);
 
@@ -255,19 +705,45 @@ MeasureResult PostgresConnector::perfile_insert(const std::string& data_dir, Dup
     return result;
 #endif
 
+    const auto files = list_data_files(dir);
+    const int workers = open_workers(tuning_.parallelism);
+
     Timer total_timer;
     total_timer.start();
 
+    result = run_partitioned(workers,
+        [&](PostgresConnector& w, int idx, int n, MeasureResult& r) {
+            w.perfile_insert_files(stride_partition(files, idx, n), r);
+        });
+
+    total_timer.stop();
+    result.duration_ns = total_timer.elapsed_ns();
+
+    LOG_INF("[%s] Per-file insert: %lld rows, %lld bytes, %lld ms",
+        system_name(), result.rows_affected, result.bytes_logical, total_timer.elapsed_ms());
+
+    return result;
+}
+
+void PostgresConnector::perfile_insert_files(const std::vector<fs::path>& files,
+                                             MeasureResult& result) {
+    // Optional pipeline mode: latencies are pushed by PgPipeline on completion
+    PgPipeline pipe(conn_, tuning_.pipeline_depth, result);
+    const bool pipelined = tuning_.pipeline_depth > 1 && pipe.begin();
+    if (pipelined) {
+        LOG_INF("[%s] Pipeline mode: depth %d", system_name(), tuning_.pipeline_depth);
+    }
+
     char insert_sql[512];
     std::snprintf(insert_sql, sizeof(insert_sql),
         "INSERT INTO %s.files (mime, size_bytes, sha256, payload) "
         "VALUES ($1, $2, $3, $4)", schema_.c_str());
 
-    for (const auto& entry : fs::directory_iterator(dir)) {
-        if (!entry.is_regular_file()) continue;
-
-        auto fsize = entry.file_size();
-        std::ifstream f(entry.path(), std::ios::binary);
+    for (const auto& path : files) {
+        std::error_code ec;
+        auto fsize = fs::file_size(path, ec);
+        if (ec) continue;
+        std::ifstream f(path, std::ios::binary);
         std::vector<char> buf(fsize);
         f.read(buf.data(), static_cast<std::streamsize>(fsize));
 
@@ -283,6 +759,13 @@ MeasureResult PostgresConnector::perfile_insert(const std::string& data_dir, Dup
         int lengths[4] = {0, 0, 0, static_cast<int>(fsize)};
         int formats[4] = {0, 0, 0, 1};
 
+        result.bytes_logical += fsize;
+        if (pipelined) {
+            // libpq copies the parameters into its send buffer -- buf may be freed
+            if (!pipe.send_params(insert_sql, 4, values, lengths, formats)) break;
+            continue;
+        }
+
         int64_t insert_ns = 0;
         {
             ScopedTimer st(insert_ns);
@@ -296,19 +779,16 @@ MeasureResult PostgresConnector::perfile_insert(const std::string& data_dir, Dup
             }
         }
         result.per_file_latencies_ns.push_back(insert_ns);
-        result.bytes_logical += fsize;
     }
+    pipe.finish();
 
-    total_timer.stop();
-    result.duration_ns = total_timer.elapsed_ns();
-
-    LOG_INF("[%s] Per-file insert: %lld rows, %lld bytes, %lld ms",
-        system_name(), result.rows_affected, result.bytes_logical, total_timer.elapsed_ms());
-
-    return result;
+    if (pipe.errors() > 0) {
+        result.error = std::to_string(pipe.errors()) + " pipelined inserts failed";
+    }
 }
 
 MeasureResult PostgresConnector::perfile_delete() {
+    size_cache_.invalidate();
     MeasureResult result{};
     LOG_INF("[%s] Per-file delete from %s.files (row-by-row)", system_name(), schema_.c_str());
 
@@ -320,47 +800,107 @@ MeasureResult PostgresConnector::perfile_delete() {
     Timer total_timer;
     total_timer.start();
 
-    // Fetch all row IDs first
-    char select_sql[256];
-    std::snprintf(select_sql, sizeof(select_sql),
-        "SELECT id::text FROM %s.files", schema_.c_str());
-    PGresult* ids_res = query(select_sql);
+    delete_rows_individually(schema_ + ".files", "id", "::uuid", result);
 
-    if (ids_res) {
-        int nrows = PQntuples(ids_res);
-        LOG_INF("[%s] Deleting %d rows individually", system_name(), nrows);
+    total_timer.stop();
+    result.duration_ns = total_timer.elapsed_ns();
+    LOG_INF("[%s] Per-file delete: %lld rows, %lld ms",
+        system_name(), result.rows_affected, total_timer.elapsed_ms());
+    return result;
+}
 
-        char delete_sql[512];
-        std::snprintf(delete_sql, sizeof(delete_sql),
-            "DELETE FROM %s.files WHERE id = $1::uuid", schema_.c_str());
+void PostgresConnector::delete_rows_individually(const std::string& table,
+                                                 const std::string& pk_col,
+                                                 const std::string& pk_cast,
+                                                 MeasureResult& result) {
+    // Keys are streamed in keyset-paginated batches (WHERE pk > last ORDER BY
+    // pk LIMIT n) so client memory is bounded by one batch. Unlike a WITH HOLD
+    // cursor this needs no server-side materialisation (no temp files on the
+    // measured volume) and works the same on CockroachDB.
+    const int batch = tuning_.delete_fetch_size > 0 ? tuning_.delete_fetch_size : 10000;
+    const std::string first_sql = "SELECT " + pk_col + "::text FROM " + table +
+        " ORDER BY " + pk_col + " LIMIT " + std::to_string(batch);
+    const std::string next_sql = "SELECT " + pk_col + "::text FROM " + table +
+        " WHERE " + pk_col + " > $1" + pk_cast +
+        " ORDER BY " + pk_col + " LIMIT " + std::to_string(batch);
+    const std::string delete_sql = "DELETE FROM " + table +
+        " WHERE " + pk_col + " = $1" + pk_cast;
+
+    const bool pipelined = tuning_.pipeline_depth > 1;
+    if (pipelined) {
+        LOG_INF("[%s] Pipelined delete: depth %d, fetch %d keys per batch",
+            system_name(), tuning_.pipeline_depth, batch);
+    }
 
-        for (int i = 0; i < nrows; ++i) {
-            const char* id_val = PQgetvalue(ids_res, i, 0);
-            const char* values[1] = { id_val };
+    std::string last_key;
+    int64_t errors = 0;
+    for (;;) {
+        PGresult* ids_res = nullptr;
+        if (last_key.empty()) {
+            ids_res = query(first_sql.c_str());
+        } else {
+            const char* params[1] = { last_key.c_str() };
+            ids_res = PQexecParams(conn_, next_sql.c_str(), 1,
+                nullptr, params, nullptr, nullptr, 0);
+            if (PQresultStatus(ids_res) != PGRES_TUPLES_OK) {
+                LOG_ERR("[%s] Key fetch error: %s", system_name(), PQerrorMessage(conn_));
+                PQclear(ids_res);
+                ids_res = nullptr;
+            }
+        }
+        if (!ids_res) break;
 
-            int64_t del_ns = 0;
-            {
-                ScopedTimer st(del_ns);
-                PGresult* del_res = PQexecParams(conn_, delete_sql, 1,
-                    nullptr, values, nullptr, nullptr, 0);
-                if (PQresultStatus(del_res) == PGRES_COMMAND_OK) {
-                    result.rows_affected++;
+        int nrows = PQntuples(ids_res);
+        if (nrows == 0) {
+            PQclear(ids_res);
+            break;
+        }
+        LOG_DBG("[%s] Deleting batch of %d rows individually", system_name(), nrows);
+
+        if (pipelined) {
+            PgPipeline pipe(conn_, tuning_.pipeline_depth, result);
+            if (pipe.begin()) {
+                for (int i = 0; i < nrows; ++i) {
+                    const char* values[1] = { PQgetvalue(ids_res, i, 0) };
+                    if (!pipe.send_params(delete_sql.c_str(), 1, values, nullptr, nullptr)) break;
                 }
-                PQclear(del_res);
+                pipe.finish();
+                errors += pipe.errors();
+            } else {
+                errors += nrows;
+            }
+        } else {
+            for (int i = 0; i < nrows; ++i) {
+                const char* values[1] = { PQgetvalue(ids_res, i, 0) };
+
+                int64_t del_ns = 0;
+                {
+                    ScopedTimer st(del_ns);
+                    PGresult* del_res = PQexecParams(conn_, delete_sql.c_str(), 1,
+                        nullptr, values, nullptr, nullptr, 0);
+                    if (PQresultStatus(del_res) == PGRES_COMMAND_OK) {
+                        result.rows_affected++;
+                    } else {
+                        ++errors;
+                    }
+                    PQclear(del_res);
+                }
+                result.per_file_latencies_ns.push_back(del_ns);
             }
-            result.per_file_latencies_ns.push_back(del_ns);
         }
+
+        last_key = PQgetvalue(ids_res, nrows - 1, 0);
         PQclear(ids_res);
+        if (nrows < batch) break;
     }
 
-    total_timer.stop();
-    result.duration_ns = total_timer.elapsed_ns();
-    LOG_INF("[%s] Per-file delete: %lld rows, %lld ms",
-        system_name(), result.rows_affected, total_timer.elapsed_ms());
-    return result;
+    if (errors > 0) {
+        result.error = std::to_string(errors) + " deletes failed";
+    }
 }
 
 MeasureResult PostgresConnector::run_maintenance() {
+    size_cache_.invalidate();
     MeasureResult result{};
     LOG_INF("[%s] Running maintenance (VACUUM FULL)", system_name());
 
@@ -369,16 +909,50 @@ MeasureResult PostgresConnector::run_maintenance() {
     return result;
 #endif
 
+    // Partitioned layout: every leaf partition in the lab schema (files and
+    // native tables), looked up and connected before the timer starts
+    std::vector<std::string> partitions;
+    int workers = 1;
+    if (partitioned()) {
+        partitions = list_partitions();
+        workers = open_workers(std::min(tuning_.maintenance_parallelism,
+                                        static_cast<int>(partitions.size())));
+    }
+
     Timer timer;
     timer.start();
 
-    char sql[256];
-    std::snprintf(sql, sizeof(sql), "VACUUM FULL %s.files", schema_.c_str());
-    exec(sql);
+    if (!partitions.empty()) {
+        // Each partition is rewritten under its own lock, so partitions on
+        // different connections are reclaimed concurrently
+        result = run_partitioned(workers,
+            [&](PostgresConnector& w, int idx, int n, MeasureResult& r) {
+                for (size_t i = static_cast<size_t>(idx); i < partitions.size();
+                     i += static_cast<size_t>(n)) {
+                    int64_t part_ns = 0;
+                    {
+                        ScopedTimer st(part_ns);
+                        std::string sql = "VACUUM FULL " + partitions[i];
+                        bool ok = w.exec(sql.c_str());
+                        sql = "REINDEX TABLE " + partitions[i];
+                        ok = w.exec(sql.c_str()) && ok;
+                        if (ok) r.rows_affected++;
+                        else r.error = "maintenance failed on " + partitions[i];
+                    }
+                    r.partition_durations_ns.push_back(part_ns);
+                }
+            });
+        LOG_INF("[%s] VACUUM FULL + REINDEX on %zu partitions over %d connections",
+            system_name(), partitions.size(), workers);
+    } else {
+        char sql[256];
+        std::snprintf(sql, sizeof(sql), "VACUUM FULL %s.files", schema_.c_str());
+        exec(sql);
 
-    // Also REINDEX
-    std::snprintf(sql, sizeof(sql), "REINDEX TABLE %s.files", schema_.c_str());
-    exec(sql);
+        // Also REINDEX
+        std::snprintf(sql, sizeof(sql), "REINDEX TABLE %s.files", schema_.c_str());
+        exec(sql);
+    }
 
     // Checkpoint to flush WAL
     exec("CHECKPOINT");
@@ -393,18 +967,13 @@ int64_t PostgresConnector::get_logical_size_bytes() {
 #ifdef DEDUP_DRY_RUN
     return 0;
 #endif
-    char sql[256];
     if (system_ == DbSystem::COCKROACHDB) {
-        // CockroachDB: no pg_total_relation_size, use crdb_internal
-        std::snprintf(sql, sizeof(sql),
-            "SELECT sum(range_size) FROM crdb_internal.ranges "
-            "WHERE database_name = '%s'", schema_.c_str());
-    } else {
-        std::snprintf(sql, sizeof(sql),
-            "SELECT pg_total_relation_size('%s.files')", schema_.c_str());
+        // CockroachDB: no pg_total_relation_size; span stats of the lab
+        // database, cached until the next write (CrdbSizeProvider)
+        return size_cache_.database_bytes(conn_, schema_);
     }
 
-    PGresult* res = query(sql);
+    PGresult* res = query(relation_size_sql(schema_ + ".files").c_str());
     if (!res) return -1;
 
     int64_t size = 0;
@@ -468,6 +1037,13 @@ std::string PostgresConnector::build_create_table_sql(const NativeSchema& ns) co
     }
 
     sql += "\n)";
+
+    // Hash-partitioned layout: the (single-column) primary key is the key
+    if (partitioned()) {
+        if (const ColumnDef* pk = ns.primary_key()) {
+            sql += " PARTITION BY HASH (" + pk->name + ")";
+        }
+    }
     return sql;
 }
 
@@ -489,58 +1065,142 @@ std::string PostgresConnector::build_insert_sql(const NativeSchema& ns) const {
            " (" + cols + ") VALUES (" + params + ")";
 }
 
-bool PostgresConnector::bind_and_exec_native(const std::string& sql,
-                                               const NativeSchema& ns,
-                                               const NativeRecord& record) {
-    if (!conn_) return false;
+const PostgresConnector::PreparedNative*
+PostgresConnector::prepare_native(const NativeSchema& ns) {
+    const std::string key = schema_ + "." + ns.table_name;
+    auto it = prepared_.find(key);
+    if (it != prepared_.end()) return &it->second;
+    if (!conn_) return nullptr;
 
-    // Collect non-SERIAL columns
-    std::vector<const ColumnDef*> insert_cols;
+    PreparedNative pn;
+    pn.name = "dedup_ins_" + schema_ + "_" + ns.table_name;
+    std::vector<Oid> oids;
     for (const auto& col : ns.columns) {
-        if (col.type_hint != "SERIAL") insert_cols.push_back(&col);
+        if (col.type_hint == "SERIAL") continue;  // Auto-generated
+        pn.columns.push_back(col.name);
+        pn.wire.push_back(pg_wire_for(col));
+        oids.push_back(pg_wire_oid(pn.wire.back()));
     }
 
-    int nparams = static_cast<int>(insert_cols.size());
-    std::vector<const char*> values(nparams, nullptr);
-    std::vector<int> lengths(nparams, 0);
-    std::vector<int> formats(nparams, 0);  // 0=text, 1=binary
-    std::vector<std::string> str_bufs(nparams);  // Keep strings alive
+    std::string sql = build_insert_sql(ns);
+    PGresult* res = PQprepare(conn_, pn.name.c_str(), sql.c_str(),
+        static_cast<int>(oids.size()), oids.data());
+    bool ok = (PQresultStatus(res) == PGRES_COMMAND_OK);
+    if (!ok) {
+        LOG_ERR("[%s] PQprepare failed for %s: %s",
+            system_name(), key.c_str(), PQerrorMessage(conn_));
+    }
+    PQclear(res);
+    if (!ok) return nullptr;
 
-    for (int i = 0; i < nparams; ++i) {
-        const auto& col_name = insert_cols[i]->name;
-        auto it = record.columns.find(col_name);
+    LOG_DBG("[%s] Prepared %s (%zu params): %s",
+        system_name(), pn.name.c_str(), pn.columns.size(), sql.c_str());
+    return &prepared_.emplace(key, std::move(pn)).first->second;
+}
 
-        if (it == record.columns.end() || std::holds_alternative<std::monostate>(it->second)) {
-            values[i] = nullptr;  // NULL
-            continue;
-        }
+void PostgresConnector::forget_prepared(const std::string& key) {
+    for (auto& w : workers_) w->forget_prepared(key);
+    auto it = prepared_.find(key);
+    if (it == prepared_.end()) return;
+    if (conn_) {
+        std::string sql = "DEALLOCATE " + it->second.name;
+        exec(sql.c_str());
+    }
+    prepared_.erase(it);
+}
+
+void PostgresConnector::bind_native(const PreparedNative& pn,
+                                    const NativeRecord& record,
+                                    NativeParams& p) const {
+    const size_t nparams = pn.columns.size();
+    p.values.assign(nparams, nullptr);
+    p.lengths.assign(nparams, 0);
+    p.formats.assign(nparams, 0);  // 0=text, 1=binary
+    p.scalars.resize(nparams);
+    if (p.str_bufs.size() < nparams) p.str_bufs.resize(nparams);
+
+    for (size_t i = 0; i < nparams; ++i) {
+        auto it = record.columns.find(pn.columns[i]);
+        if (it == record.columns.end()) continue;  // NULL
+
+        const PgWire w = pn.wire[i];
+        char* scalar = p.scalars[i].data();
+
+        // Binary encodings for fixed-width types; anything that does not match
+        // the column type is sent as text and converted by the server.
+        auto binary = [&](const char* data, size_t len) {
+            p.values[i] = data;
+            p.lengths[i] = static_cast<int>(len);
+            p.formats[i] = 1;
+        };
+        auto text = [&](std::string s) {
+            p.str_bufs[i] = std::move(s);
+            p.values[i] = p.str_bufs[i].c_str();
+        };
 
         std::visit([&](const auto& v) {
             using T = std::decay_t<decltype(v)>;
             if constexpr (std::is_same_v<T, std::monostate>) {
-                values[i] = nullptr;
+                // NULL
             } else if constexpr (std::is_same_v<T, bool>) {
-                str_bufs[i] = v ? "t" : "f";
-                values[i] = str_bufs[i].c_str();
+                if (w == PgWire::BOOL) {
+                    scalar[0] = v ? 1 : 0;
+                    binary(scalar, 1);
+                } else if (w == PgWire::INT8) {
+                    pg_store_be64(scalar, v ? 1 : 0);
+                    binary(scalar, 8);
+                } else {
+                    text(v ? "t" : "f");
+                }
             } else if constexpr (std::is_same_v<T, int64_t>) {
-                str_bufs[i] = std::to_string(v);
-                values[i] = str_bufs[i].c_str();
+                if (w == PgWire::INT8) {
+                    pg_store_be64(scalar, static_cast<uint64_t>(v));
+                    binary(scalar, 8);
+                } else if (w == PgWire::INT4 && v >= INT32_MIN && v <= INT32_MAX) {
+                    pg_store_be32(scalar, static_cast<uint32_t>(static_cast<int32_t>(v)));
+                    binary(scalar, 4);
+                } else if (w == PgWire::FLOAT8) {
+                    pg_store_be64(scalar, pg_float8_bits(static_cast<double>(v)));
+                    binary(scalar, 8);
+                } else {
+                    text(std::to_string(v));
+                }
             } else if constexpr (std::is_same_v<T, double>) {
-                str_bufs[i] = std::to_string(v);
-                values[i] = str_bufs[i].c_str();
+                if (w == PgWire::FLOAT8) {
+                    pg_store_be64(scalar, pg_float8_bits(v));
+                    binary(scalar, 8);
+                } else {
+                    // %.17g round-trips every double (std::to_string keeps 6 digits)
+                    char buf[32];
+                    std::snprintf(buf, sizeof(buf), "%.17g", v);
+                    text(buf);
+                }
             } else if constexpr (std::is_same_v<T, std::string>) {
-                values[i] = v.c_str();
-                lengths[i] = static_cast<int>(v.size());
+                if (w == PgWire::BYTEA || w == PgWire::TEXT || w == PgWire::BPCHAR) {
+                    binary(v.data(), v.size());  // raw bytes, no escaping
+                } else {
+                    p.values[i] = v.c_str();  // JSONB, TIMESTAMPTZ, UUID: text input
+                }
             } else if constexpr (std::is_same_v<T, std::vector<char>>) {
-                values[i] = v.data();
-                lengths[i] = static_cast<int>(v.size());
-                formats[i] = 1;  // Binary format for BYTEA
+                if (w == PgWire::BYTEA || w == PgWire::TEXT || w == PgWire::BPCHAR) {
+                    binary(v.data(), v.size());
+                } else {
+                    text(std::string(v.begin(), v.end()));
+                }
             }
         }, it->second);
     }
+}
+
+bool PostgresConnector::exec_native(const PreparedNative& pn,
+                                    const NativeRecord& record,
+                                    NativeParams& p) {
+    if (!conn_) return false;
 
-    PGresult* res = PQexecParams(conn_, sql.c_str(), nparams,
-        nullptr, values.data(), lengths.data(), formats.data(), 0);
+    bind_native(pn, record, p);
+
+    PGresult* res = PQexecPrepared(conn_, pn.name.c_str(), static_cast<int>(p.values.size()),
+        p.values.data(), p.lengths.data(), p.formats.data(), 0);
     bool ok = (PQresultStatus(res) == PGRES_COMMAND_OK);
     if (!ok) {
         LOG_ERR("[%s] Native insert error: %s", system_name(), PQerrorMessage(conn_));
@@ -550,6 +1210,7 @@ bool PostgresConnector::bind_and_exec_native(const std::string& sql,
 }
 
 bool PostgresConnector::create_native_schema(const std::string& schema_name, PayloadType type) {
+    size_cache_.invalidate();
     schema_ = schema_name;
     LOG_INF("[%s] Creating native schema for %s in %s",
         system_name(), payload_type_str(type), schema_name.c_str());
@@ -569,11 +1230,24 @@ bool PostgresConnector::create_native_schema(const std::string& schema_name, Pay
     auto ns = get_native_schema(type);
     std::string create_sql = build_create_table_sql(ns);
     LOG_DBG("[%s] CREATE TABLE SQL: %s", system_name(), create_sql.c_str());
-    return exec(create_sql.c_str());
+    if (!exec(create_sql.c_str())) return false;
+    if (partitioned() && ns.primary_key() &&
+        !create_hash_partitions(schema_name + "." + ns.table_name)) return false;
+
+    // Variable-length columns are the ones TOAST strategy/compression affect
+    std::vector<std::string> toastable;
+    for (const auto& col : ns.columns) {
+        if (col.type_hint == "BYTEA" || col.type_hint == "JSONB" || col.type_hint == "TEXT") {
+            toastable.push_back(col.name);
+        }
+    }
+    return apply_storage_variant(schema_name + "." + ns.table_name, toastable);
 }
 
 bool PostgresConnector::drop_native_schema(const std::string& schema_name, PayloadType type) {
+    size_cache_.invalidate();
     auto ns = get_native_schema(type);
+    forget_prepared(schema_name + "." + ns.table_name);
     char sql[256];
     std::snprintf(sql, sizeof(sql), "DROP TABLE IF EXISTS %s.%s CASCADE",
         schema_name.c_str(), ns.table_name.c_str());
@@ -583,6 +1257,7 @@ bool PostgresConnector::drop_native_schema(const std::string& schema_name, Paylo
 MeasureResult PostgresConnector::native_bulk_insert(
     const std::vector<NativeRecord>& records, PayloadType type) {
 
+    size_cache_.invalidate();
     MeasureResult result{};
     LOG_INF("[%s] Native bulk insert: %zu records (type: %s)",
         system_name(), records.size(), payload_type_str(type));
@@ -593,33 +1268,224 @@ MeasureResult PostgresConnector::native_bulk_insert(
 #endif
 
     auto ns = get_native_schema(type);
-    std::string insert_sql = build_insert_sql(ns);
+    const int workers = open_workers(tuning_.parallelism);
 
     Timer timer;
     timer.start();
 
+    result = run_partitioned(workers,
+        [&](PostgresConnector& w, int idx, int n, MeasureResult& r) {
+            w.native_bulk_records(ns, range_partition(records, idx, n), r);
+        });
+
+    timer.stop();
+    result.duration_ns = timer.elapsed_ns();
+
+    LOG_INF("[%s] Native bulk insert: %lld rows, %lld bytes, %lld ms",
+        system_name(), result.rows_affected, result.bytes_logical, timer.elapsed_ms());
+    return result;
+}
+
+void PostgresConnector::native_bulk_records(const NativeSchema& ns,
+                                            std::span<const NativeRecord> records,
+                                            MeasureResult& result) {
+    if (use_crdb_batches()) {
+        crdb_insert_records(ns, records, result);
+        return;
+    }
+
+    // Typed COPY BINARY; fall back to prepared INSERTs in one transaction
+    // if COPY is refused or a value has no binary encoding.
+    if (native_copy(ns, records, result)) return;
+
+    result = MeasureResult{};
+    const PreparedNative* pn = prepare_native(ns);
+    if (!pn) {
+        result.error = "PQprepare failed for " + ns.table_name;
+        return;
+    }
+    NativeParams params;
+
     exec("BEGIN");
 
     for (const auto& rec : records) {
-        if (bind_and_exec_native(insert_sql, ns, rec)) {
+        if (exec_native(*pn, rec, params)) {
             result.rows_affected++;
             result.bytes_logical += static_cast<int64_t>(rec.estimated_size_bytes());
         }
     }
 
     exec("COMMIT");
+}
 
-    timer.stop();
-    result.duration_ns = timer.elapsed_ns();
+void PostgresConnector::crdb_insert_records(const NativeSchema& ns,
+                                            std::span<const NativeRecord> records,
+                                            MeasureResult& result) {
+    // Same wire types as the prepared INSERT (no PQprepare: the statement
+    // text depends on the batch size). Defaulted columns no record provides
+    // are left out so the server applies the DEFAULT, as in native_copy.
+    PreparedNative cols;
+    std::string col_list;
+    std::vector<Oid> col_oids;
+    for (const auto& col : ns.columns) {
+        if (col.type_hint == "SERIAL") continue;  // Auto-generated
+        if (!col.default_expr.empty()) {
+            bool provided = std::any_of(records.begin(), records.end(),
+                [&](const NativeRecord& r) {
+                    auto it = r.columns.find(col.name);
+                    return it != r.columns.end() &&
+                           !std::holds_alternative<std::monostate>(it->second);
+                });
+            if (!provided) continue;
+        }
+        if (!cols.columns.empty()) col_list += ", ";
+        col_list += col.name;
+        cols.columns.push_back(col.name);
+        cols.wire.push_back(pg_wire_for(col));
+        col_oids.push_back(pg_wire_oid(cols.wire.back()));
+    }
+    const size_t ncols = cols.columns.size();
+    if (ncols == 0) return;
+    const size_t max_rows = std::min(static_cast<size_t>(std::max(tuning_.crdb_batch_rows, 1)),
+                                     65535 / ncols);
+
+    // One NativeParams per batch row, never resized: bound pointers stay valid
+    std::vector<NativeParams> rows(max_rows);
+    size_t nrows = 0;
+    int64_t batch_bytes = 0;
+
+    std::string sql;
+    std::vector<const char*> values;
+    std::vector<int> lengths, formats;
+    std::vector<Oid> oids;
+
+    auto flush = [&]() {
+        if (nrows == 0) return;
+
+        sql = "INSERT INTO " + schema_ + "." + ns.table_name + " (" + col_list + ") VALUES ";
+        values.clear();
+        lengths.clear();
+        formats.clear();
+        oids.clear();
+        size_t param = 0;
+        for (size_t r = 0; r < nrows; ++r) {
+            sql += r > 0 ? ", (" : "(";
+            for (size_t c = 0; c < ncols; ++c) {
+                if (c > 0) sql += ", ";
+                sql += "$" + std::to_string(++param);
+            }
+            sql += ")";
+            values.insert(values.end(), rows[r].values.begin(), rows[r].values.end());
+            lengths.insert(lengths.end(), rows[r].lengths.begin(), rows[r].lengths.end());
+            formats.insert(formats.end(), rows[r].formats.begin(), rows[r].formats.end());
+            oids.insert(oids.end(), col_oids.begin(), col_oids.end());
+        }
 
-    LOG_INF("[%s] Native bulk insert: %lld rows, %lld bytes, %lld ms",
-        system_name(), result.rows_affected, result.bytes_logical, timer.elapsed_ms());
-    return result;
+        int64_t affected = 0;
+        std::string err;
+        bool ok = crdb_retry_txn(conn_, tuning_.crdb_max_retries, [&] {
+            return PQexecParams(conn_, sql.c_str(), static_cast<int>(values.size()), oids.data(),
+                values.data(), lengths.data(), formats.data(), 0);
+        }, result.txn_retries, affected, err);
+
+        if (ok) {
+            result.rows_affected += affected;
+        } else {
+            LOG_ERR("[%s] Native batched INSERT of %zu rows failed: %s",
+                system_name(), nrows, err.c_str());
+            result.error = err;
+        }
+        nrows = 0;
+        batch_bytes = 0;
+    };
+
+    for (const auto& rec : records) {
+        bind_native(cols, rec, rows[nrows++]);
+        const auto size = static_cast<int64_t>(rec.estimated_size_bytes());
+        result.bytes_logical += size;
+        batch_bytes += size;
+        if (nrows >= max_rows || batch_bytes >= tuning_.crdb_batch_bytes) flush();
+    }
+    flush();
+}
+
+bool PostgresConnector::native_copy(const NativeSchema& ns,
+                                    std::span<const NativeRecord> records,
+                                    MeasureResult& result) {
+    // Column set: every non-SERIAL column, except defaulted columns that no
+    // record provides -- those are left out of the column list so the server
+    // applies the DEFAULT (e.g. timestamptz now()) as a plain INSERT would.
+    std::vector<const ColumnDef*> cols;
+    std::vector<PgWire> wire;
+    for (const auto& col : ns.columns) {
+        if (col.type_hint == "SERIAL") continue;
+        if (!col.default_expr.empty()) {
+            bool provided = std::any_of(records.begin(), records.end(),
+                [&](const NativeRecord& r) {
+                    auto it = r.columns.find(col.name);
+                    return it != r.columns.end() &&
+                           !std::holds_alternative<std::monostate>(it->second);
+                });
+            if (!provided) continue;
+        }
+        cols.push_back(&col);
+        wire.push_back(pg_wire_for(col));
+    }
+    if (cols.empty()) return false;
+
+    std::string copy_sql = "COPY " + schema_ + "." + ns.table_name + " (";
+    for (size_t i = 0; i < cols.size(); ++i) {
+        if (i > 0) copy_sql += ", ";
+        copy_sql += cols[i]->name;
+    }
+    copy_sql += ") FROM STDIN WITH (FORMAT binary)";
+
+    PgCopyWriter copy(conn_, static_cast<size_t>(tuning_.copy_buffer_bytes));
+    if (!copy.begin(copy_sql)) {
+        LOG_WRN("[%s] Native COPY start failed: %s -- using prepared INSERT",
+            system_name(), copy.error().c_str());
+        return false;
+    }
+
+    const auto nfields = static_cast<int16_t>(cols.size());
+    static const ColumnValue null_value{};
+    int64_t bytes = 0;
+
+    for (const auto& rec : records) {
+        copy.begin_tuple(nfields);
+        for (size_t i = 0; i < cols.size(); ++i) {
+            auto it = rec.columns.find(cols[i]->name);
+            const ColumnValue& v = (it != rec.columns.end()) ? it->second : null_value;
+            if (!copy.put_value(v, wire[i])) {
+                LOG_WRN("[%s] No binary encoding for %s.%s (%s) -- aborting COPY",
+                    system_name(), ns.table_name.c_str(), cols[i]->name.c_str(),
+                    cols[i]->type_hint.c_str());
+                copy.abort("value without binary encoding");
+                return false;
+            }
+        }
+        if (!copy.ok()) break;
+        bytes += static_cast<int64_t>(rec.estimated_size_bytes());
+    }
+
+    int64_t copied = 0;
+    if (copy.finish(&copied)) {
+        result.rows_affected = copied;
+        result.bytes_logical = bytes;
+    } else {
+        result.error = "Native COPY failed: " + copy.error();
+        LOG_ERR("[%s] %s", system_name(), result.error.c_str());
+    }
+    LOG_DBG("[%s] Native COPY %s: %zu columns, %lld wire bytes",
+        system_name(), ns.table_name.c_str(), cols.size(),
+        static_cast<long long>(copy.bytes_sent()));
+    return true;
 }
 
 MeasureResult PostgresConnector::native_perfile_insert(
     const std::vector<NativeRecord>& records, PayloadType type) {
 
+    size_cache_.invalidate();
     MeasureResult result{};
     LOG_INF("[%s] Native per-file insert: %zu records (type: %s)",
         system_name(), records.size(), payload_type_str(type));
@@ -629,33 +1495,74 @@ MeasureResult PostgresConnector::native_perfile_insert(
     return result;
 #endif
 
+    // Prepare on every connection before the timer (and before entering
+    // pipeline mode -- PQprepare is synchronous)
     auto ns = get_native_schema(type);
-    std::string insert_sql = build_insert_sql(ns);
+    const int workers = open_workers(tuning_.parallelism);
+    for (int i = 0; i < workers; ++i) {
+        if (!worker(i).prepare_native(ns)) {
+            result.error = "PQprepare failed for " + ns.table_name;
+            return result;
+        }
+    }
 
     Timer total_timer;
     total_timer.start();
 
+    result = run_partitioned(workers,
+        [&](PostgresConnector& w, int idx, int n, MeasureResult& r) {
+            w.native_perfile_records(ns, range_partition(records, idx, n), r);
+        });
+
+    total_timer.stop();
+    result.duration_ns = total_timer.elapsed_ns();
+
+    LOG_INF("[%s] Native per-file insert: %lld rows, %lld bytes, %lld ms",
+        system_name(), result.rows_affected, result.bytes_logical, total_timer.elapsed_ms());
+    return result;
+}
+
+void PostgresConnector::native_perfile_records(const NativeSchema& ns,
+                                               std::span<const NativeRecord> records,
+                                               MeasureResult& result) {
+    const PreparedNative* pn = prepare_native(ns);
+    if (!pn) {
+        result.error = "PQprepare failed for " + ns.table_name;
+        return;
+    }
+    NativeParams params;
+
+    PgPipeline pipe(conn_, tuning_.pipeline_depth, result);
+    const bool pipelined = tuning_.pipeline_depth > 1 && pipe.begin();
+
     for (const auto& rec : records) {
+        if (pipelined) {
+            bind_native(*pn, rec, params);
+            if (!pipe.send_prepared(pn->name.c_str(), static_cast<int>(params.values.size()),
+                    params.values.data(), params.lengths.data(), params.formats.data())) break;
+            result.bytes_logical += static_cast<int64_t>(rec.estimated_size_bytes());
+            continue;
+        }
+
         int64_t insert_ns = 0;
         {
             ScopedTimer st(insert_ns);
-            if (bind_and_exec_native(insert_sql, ns, rec)) {
+            if (exec_native(*pn, rec, params)) {
                 result.rows_affected++;
             }
         }
         result.per_file_latencies_ns.push_back(insert_ns);
         result.bytes_logical += static_cast<int64_t>(rec.estimated_size_bytes());
     }
+    pipe.finish();
 
-    total_timer.stop();
-    result.duration_ns = total_timer.elapsed_ns();
-
-    LOG_INF("[%s] Native per-file insert: %lld rows, %lld bytes, %lld ms",
-        system_name(), result.rows_affected, result.bytes_logical, total_timer.elapsed_ms());
-    return result;
+    if (pipe.errors() > 0) {
+        result.error = std::to_string(pipe.errors()) + " pipelined native inserts failed";
+    }
 }
 
 MeasureResult PostgresConnector::native_perfile_delete(PayloadType type) {
+    size_cache_.invalidate();
     MeasureResult result{};
     auto ns = get_native_schema(type);
     const auto* pk = ns.primary_key();
@@ -670,46 +1577,17 @@ MeasureResult PostgresConnector::native_perfile_delete(PayloadType type) {
     Timer total_timer;
     total_timer.start();
 
-    // Fetch all primary key values
+    // Cast the text key parameter back to the PK type
     std::string pk_col = pk ? pk->name : "id";
-    char select_sql[256];
-    std::snprintf(select_sql, sizeof(select_sql),
-        "SELECT %s::text FROM %s.%s",
-        pk_col.c_str(), schema_.c_str(), ns.table_name.c_str());
-
-    PGresult* ids_res = query(select_sql);
-    if (ids_res) {
-        int nrows = PQntuples(ids_res);
-        LOG_INF("[%s] Deleting %d native records individually", system_name(), nrows);
-
-        // Build delete SQL based on PK type
-        std::string delete_sql = "DELETE FROM " + schema_ + "." + ns.table_name +
-            " WHERE " + pk_col + " = $1";
-        if (pk && (pk->type_hint == "UUID")) {
-            delete_sql += "::uuid";
-        } else if (pk && (pk->type_hint == "SERIAL" || pk->type_hint == "INT" || pk->type_hint == "BIGINT")) {
-            delete_sql += "::bigint";
-        }
-
-        for (int i = 0; i < nrows; ++i) {
-            const char* id_val = PQgetvalue(ids_res, i, 0);
-            const char* values[1] = { id_val };
-
-            int64_t del_ns = 0;
-            {
-                ScopedTimer st(del_ns);
-                PGresult* del_res = PQexecParams(conn_, delete_sql.c_str(), 1,
-                    nullptr, values, nullptr, nullptr, 0);
-                if (PQresultStatus(del_res) == PGRES_COMMAND_OK) {
-                    result.rows_affected++;
-                }
-                PQclear(del_res);
-            }
-            result.per_file_latencies_ns.push_back(del_ns);
-        }
-        PQclear(ids_res);
+    std::string pk_cast;
+    if (pk && (pk->type_hint == "UUID")) {
+        pk_cast = "::uuid";
+    } else if (pk && (pk->type_hint == "SERIAL" || pk->type_hint == "INT" || pk->type_hint == "BIGINT")) {
+        pk_cast = "::bigint";
     }
 
+    delete_rows_individually(schema_ + "." + ns.table_name, pk_col, pk_cast, result);
+
     total_timer.stop();
     result.duration_ns = total_timer.elapsed_ns();
     LOG_INF("[%s] Native per-file delete: %lld rows, %lld ms",
@@ -721,19 +1599,12 @@ int64_t PostgresConnector::get_native_logical_size_bytes(PayloadType type) {
 #ifdef DEDUP_DRY_RUN
     return 0;
 #endif
-    auto ns = get_native_schema(type);
-    char sql[256];
     if (system_ == DbSystem::COCKROACHDB) {
-        std::snprintf(sql, sizeof(sql),
-            "SELECT sum(range_size) FROM crdb_internal.ranges "
-            "WHERE database_name = '%s'", schema_.c_str());
-    } else {
-        std::snprintf(sql, sizeof(sql),
-            "SELECT pg_total_relation_size('%s.%s')",
-            schema_.c_str(), ns.table_name.c_str());
+        return size_cache_.database_bytes(conn_, schema_);
     }
 
-    PGresult* res = query(sql);
+    auto ns = get_native_schema(type);
+    PGresult* res = query(relation_size_sql(schema_ + "." + ns.table_name).c_str());
     if (!res) return -1;
 
     int64_t size = 0;
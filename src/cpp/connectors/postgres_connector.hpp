@@ -7,15 +7,42 @@
 //   - native_bulk_insert: Inserts NativeRecords in transaction batch
 //   - native_perfile_insert: Inserts NativeRecords with per-record latency
 //   - native_perfile_delete: Deletes all records from native table
+//
+// BLOB bulk_insert streams files through COPY ... FROM STDIN (FORMAT binary)
+// via PgCopyWriter; per-row INSERT is kept as fallback only.
+// Per-file inserts optionally run in libpq pipeline mode (PgPipeline) with
+// PostgresTuning::pipeline_depth requests in flight.
+// native_bulk_insert uses a typed COPY BINARY driven by the NativeSchema.
+// Native inserts use one PQprepare'd statement per table (cached per
+// connection) with binary-encoded parameters.
+// With PostgresTuning::parallelism > 1 the load stages open extra worker
+// connections, split the sorted input deterministically across them and
+// run each part on its own thread (own transaction per worker).
+// CockroachDB bulk stages load through multi-row INSERT transactions with
+// the 40001 retry loop (crdb_client.hpp); parallel workers connect to all
+// live gateway nodes.
+// PostgreSQL lab tables can be created in storage-strategy variants (TOAST
+// strategy, compression method, fillfactor) that form an extra run dimension,
+// and optionally hash-partitioned; maintenance then reclaims partitions in
+// parallel over worker connections.
 #include "db_connector.hpp"
+#include "pg_wire.hpp"
+#include "crdb_client.hpp"
+#include <array>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <span>
 #include <libpq-fe.h>
 
 namespace dedup {
 
 class PostgresConnector : public DbConnector {
 public:
-    explicit PostgresConnector(DbSystem sys = DbSystem::POSTGRESQL)
-        : system_(sys) {}
+    explicit PostgresConnector(DbSystem sys = DbSystem::POSTGRESQL,
+                               const PostgresTuning& tuning = {})
+        : system_(sys), tuning_(tuning) {}
 
     ~PostgresConnector() override { disconnect(); }
 
@@ -48,22 +75,121 @@ public:
     MeasureResult native_perfile_delete(PayloadType type) override;
     int64_t get_native_logical_size_bytes(PayloadType type) override;
 
+    // Storage-strategy variants (PostgresTuning::storage_variants, PostgreSQL only)
+    [[nodiscard]] std::vector<std::string> variants() const override;
+    bool select_variant(const std::string& name) override;
+    [[nodiscard]] std::string current_variant() const override {
+        return variant_ ? variant_->label() : "";
+    }
+
 private:
     DbSystem system_;
+    PostgresTuning tuning_;
     PGconn* conn_ = nullptr;
     std::string schema_;
+    DbConnection conn_info_{};
+    bool has_conn_info_ = false;
+
+    // Extra connections for parallel stages; participant 0 is *this
+    std::vector<std::unique_ptr<PostgresConnector>> workers_;
+    std::vector<CrdbGateway> gateways_;  // COCKROACHDB: live nodes, discovered once
+    CrdbSizeProvider size_cache_;        // COCKROACHDB: logical size, invalidated by writes
+
+    // Selected storage variant (points into tuning_.storage_variants)
+    const PgStorageVariant* variant_ = nullptr;
+    // ALTER TABLE ... SET STORAGE / SET COMPRESSION on `columns`, SET (fillfactor)
+    bool apply_storage_variant(const std::string& table, const std::vector<std::string>& columns);
+
+    // Hash-partitioned layout (PostgresTuning::hash_partitions, PostgreSQL only):
+    // partitions are named <table>_p<remainder>
+    [[nodiscard]] bool partitioned() const;
+    bool create_hash_partitions(const std::string& table);
+    std::vector<std::string> list_partitions();  // leaf partitions in schema_
+    // pg_total_relation_size query, summed over partitions when partitioned
+    [[nodiscard]] std::string relation_size_sql(const std::string& table) const;
+    using PartitionFn = std::function<void(PostgresConnector& conn, int idx, int n,
+                                           MeasureResult& part)>;
+    // Opens missing worker connections (outside the timed region) and
+    // returns the number of participants actually available (<= wanted).
+    int open_workers(int wanted);
+    PostgresConnector& worker(int idx);
+    // Runs fn once per participant (threads only when n > 1) and merges the
+    // per-worker results; worker wall times go to worker_durations_ns.
+    MeasureResult run_partitioned(int n, const PartitionFn& fn);
+    static std::vector<std::filesystem::path> list_data_files(const std::string& dir);
+    static std::vector<std::filesystem::path> stride_partition(
+        const std::vector<std::filesystem::path>& all, int idx, int n);
+    static std::span<const NativeRecord> range_partition(
+        const std::vector<NativeRecord>& all, int idx, int n);
 
     // Execute SQL with error checking, returns true on success
     bool exec(const char* sql);
     // Execute SQL and return result set (caller must PQclear)
     PGresult* query(const char* sql);
 
+    // BLOB bulk load helpers
+    static constexpr size_t COPY_READ_CHUNK_BYTES = 256 * 1024;
+    // Streams every file through COPY BINARY. Returns false only if COPY could
+    // not be started (caller falls back); stream errors land in result.error.
+    bool bulk_copy_files(const std::vector<std::filesystem::path>& files, MeasureResult& result);
+    void bulk_insert_rowwise(const std::vector<std::filesystem::path>& files, MeasureResult& result);
+    void perfile_insert_files(const std::vector<std::filesystem::path>& files, MeasureResult& result);
+
+    // CockroachDB batched INSERT path (PostgresTuning::crdb_batch_rows > 0);
+    // 40001 retries are added to result.txn_retries. Plain INSERT, not
+    // UPSERT: a repeated primary key fails the batch as it fails PostgreSQL's
+    // COPY, instead of silently overwriting the earlier row.
+    [[nodiscard]] bool use_crdb_batches() const {
+        return system_ == DbSystem::COCKROACHDB && tuning_.crdb_batch_rows > 0;
+    }
+    void crdb_insert_files(const std::vector<std::filesystem::path>& files, MeasureResult& result);
+
+    // Stage 3 helper: deletes every row of `table` one statement at a time,
+    // streaming keys in PostgresTuning::delete_fetch_size batches and
+    // pipelining the deletes when pipeline_depth > 1.
+    void delete_rows_individually(const std::string& table, const std::string& pk_col,
+                                  const std::string& pk_cast, MeasureResult& result);
+
     // Native helpers
     std::string pg_type_for(const ColumnDef& col) const;
     std::string build_create_table_sql(const NativeSchema& schema) const;
     std::string build_insert_sql(const NativeSchema& schema) const;
-    bool bind_and_exec_native(const std::string& sql, const NativeSchema& schema,
-                               const NativeRecord& record);
+
+    // Per-connection prepared INSERT cache, one entry per native table.
+    // Parameters use the binary wire format where the value matches the
+    // column type (int8, int4, float8, bool, text, bytea); see pg_wire.hpp.
+    struct PreparedNative {
+        std::string name;                  // server-side statement name
+        std::vector<std::string> columns;  // non-SERIAL columns, parameter order
+        std::vector<PgWire> wire;
+    };
+    std::map<std::string, PreparedNative> prepared_;  // key: schema.table
+
+    // Bound parameter arrays for one native record, reused across records
+    struct NativeParams {
+        std::vector<const char*> values;
+        std::vector<int> lengths;
+        std::vector<int> formats;
+        std::vector<std::array<char, 8>> scalars;  // binary int/float/bool values
+        std::vector<std::string> str_bufs;         // text fallbacks
+    };
+    const PreparedNative* prepare_native(const NativeSchema& schema);
+    void forget_prepared(const std::string& key);
+    void bind_native(const PreparedNative& pn, const NativeRecord& record,
+                     NativeParams& params) const;
+    bool exec_native(const PreparedNative& pn, const NativeRecord& record,
+                     NativeParams& params);
+
+    // Typed COPY BINARY of native records. Returns false if COPY cannot be
+    // used (caller falls back to prepared INSERT); stream errors go to result.
+    bool native_copy(const NativeSchema& schema, std::span<const NativeRecord> records,
+                     MeasureResult& result);
+    void native_bulk_records(const NativeSchema& schema, std::span<const NativeRecord> records,
+                             MeasureResult& result);
+    void crdb_insert_records(const NativeSchema& schema, std::span<const NativeRecord> records,
+                             MeasureResult& result);
+    void native_perfile_records(const NativeSchema& schema, std::span<const NativeRecord> records,
+                                MeasureResult& result);
 };
 
 } // namespace dedup
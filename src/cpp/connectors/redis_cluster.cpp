@@ -0,0 +1,211 @@
+#include "redis_cluster.hpp"
+#include "../utils/logger.hpp"
+#include <cstdlib>
+
+#ifdef HAS_HIREDIS
+#include <hiredis/hiredis.h>
+#endif
+
+namespace dedup {
+
+uint16_t RedisCluster::key_slot(std::string_view key) {
+    // Only the part inside the first {...} is hashed if it is non-empty
+    auto open = key.find('{');
+    if (open != std::string_view::npos) {
+        auto close = key.find('}', open + 1);
+        if (close != std::string_view::npos && close > open + 1) {
+            key = key.substr(open + 1, close - open - 1);
+        }
+    }
+
+    // CRC16-CCITT (XMODEM): poly 0x1021, init 0 -- as in the cluster spec
+    uint16_t crc = 0;
+    for (unsigned char c : key) {
+        crc ^= static_cast<uint16_t>(c << 8);
+        for (int i = 0; i < 8; ++i) {
+            crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021)
+                                 : static_cast<uint16_t>(crc << 1);
+        }
+    }
+    return static_cast<uint16_t>(crc & (SLOTS - 1));
+}
+
+int RedisCluster::node_for(std::string_view key) const {
+    if (!cluster_) return 0;
+    return slot_node_[key_slot(key)];
+}
+
+redisContext* RedisCluster::context(int node) const {
+    if (node < 0 || static_cast<size_t>(node) >= nodes_.size()) return nullptr;
+    return nodes_[static_cast<size_t>(node)].ctx;
+}
+
+std::string RedisCluster::node_name(int node) const {
+    if (node < 0 || static_cast<size_t>(node) >= nodes_.size()) return "?";
+    const auto& n = nodes_[static_cast<size_t>(node)];
+    return n.host + ":" + std::to_string(n.port);
+}
+
+std::vector<int> RedisCluster::masters() const {
+    std::vector<bool> owns(nodes_.size(), false);
+    if (!cluster_) {
+        if (!nodes_.empty()) owns[0] = true;
+    } else {
+        for (int16_t n : slot_node_) {
+            if (n >= 0) owns[static_cast<size_t>(n)] = true;
+        }
+    }
+    std::vector<int> out;
+    for (size_t i = 0; i < owns.size(); ++i) {
+        if (owns[i]) out.push_back(static_cast<int>(i));
+    }
+    return out;
+}
+
+#ifdef HAS_HIREDIS
+
+redisContext* redis_open(const std::string& host, int port, const DbConnection& conn) {
+    struct timeval timeout = {10, 0};
+    auto* c = redisConnectWithTimeout(host.c_str(), port, timeout);
+    if (!c || c->err) {
+        LOG_ERR("[redis] Connection to %s:%d failed: %s",
+            host.c_str(), port, c ? c->errstr : "null context");
+        if (c) redisFree(c);
+        return nullptr;
+    }
+
+    // Authenticate if credentials are provided (Redis 6+ ACL)
+    redisReply* auth = nullptr;
+    if (!conn.user.empty() && !conn.password.empty()) {
+        auth = static_cast<redisReply*>(
+            redisCommand(c, "AUTH %s %s", conn.user.c_str(), conn.password.c_str()));
+    } else if (!conn.password.empty()) {
+        auth = static_cast<redisReply*>(redisCommand(c, "AUTH %s", conn.password.c_str()));
+    } else {
+        return c;
+    }
+    if (!auth || auth->type == REDIS_REPLY_ERROR) {
+        LOG_ERR("[redis] AUTH on %s:%d failed: %s",
+            host.c_str(), port, auth ? auth->str : "null");
+        if (auth) freeReplyObject(auth);
+        redisFree(c);
+        return nullptr;
+    }
+    freeReplyObject(auth);
+    return c;
+}
+
+bool RedisCluster::init(redisContext* seed, const DbConnection& conn, bool use_cluster) {
+    close();
+    seed_ = seed;
+    conn_ = conn;
+    cluster_ = false;
+    nodes_.push_back({conn.host, conn.port, seed, false});
+    slot_node_.fill(0);
+
+    if (use_cluster && load_slots(seed)) {
+        cluster_ = true;
+        LOG_DBG("[redis] Cluster mode: %zu masters", masters().size());
+    } else {
+        LOG_DBG("[redis] Standalone routing: all keys to %s:%u",
+            conn.host.c_str(), conn.port);
+    }
+    return true;
+}
+
+bool RedisCluster::refresh() {
+    if (!cluster_) return true;
+    // Any known node can answer; try the seed first
+    if (load_slots(seed_)) return true;
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        if (nodes_[i].ctx && nodes_[i].ctx != seed_ && load_slots(nodes_[i].ctx)) return true;
+    }
+    LOG_ERR("[redis] Cluster topology refresh failed");
+    return false;
+}
+
+void RedisCluster::close() {
+    for (auto& n : nodes_) {
+        if (n.owned && n.ctx) redisFree(n.ctx);
+    }
+    nodes_.clear();
+    cluster_ = false;
+}
+
+int RedisCluster::node_index(const std::string& host, int port) {
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        if (nodes_[i].host == host && nodes_[i].port == port) return static_cast<int>(i);
+    }
+    auto* c = redis_open(host, port, conn_);
+    if (!c) return -1;
+    nodes_.push_back({host, port, c, true});
+    LOG_DBG("[redis] Connected to cluster node %s:%d", host.c_str(), port);
+    return static_cast<int>(nodes_.size() - 1);
+}
+
+int RedisCluster::node_by_addr(const std::string& addr) {
+    auto colon = addr.rfind(':');
+    if (colon == std::string::npos) return -1;
+    std::string host = addr.substr(0, colon);
+    if (host.empty()) host = conn_.host;
+    return node_index(host, std::atoi(addr.c_str() + colon + 1));
+}
+
+bool RedisCluster::load_slots(redisContext* from) {
+    auto* reply = static_cast<redisReply*>(redisCommand(from, "CLUSTER SLOTS"));
+    if (!reply || reply->type != REDIS_REPLY_ARRAY || reply->elements == 0) {
+        // "ERR This instance has cluster support disabled" -> standalone
+        if (reply && reply->type == REDIS_REPLY_ERROR)
+            LOG_DBG("[redis] CLUSTER SLOTS: %s", reply->str);
+        if (reply) freeReplyObject(reply);
+        return false;
+    }
+
+    // Each entry: [start, end, [host, port, id, ...] (master), replicas...]
+    std::array<int16_t, SLOTS> map;
+    map.fill(-1);
+    bool ok = true;
+    for (size_t i = 0; i < reply->elements && ok; ++i) {
+        auto* e = reply->element[i];
+        if (e->type != REDIS_REPLY_ARRAY || e->elements < 3 ||
+            e->element[2]->type != REDIS_REPLY_ARRAY || e->element[2]->elements < 2) {
+            continue;
+        }
+        auto* master = e->element[2];
+        // Empty host = "the node you are talking to" (announce-less setups)
+        std::string host = master->element[0]->str ? master->element[0]->str : "";
+        if (host.empty() || host == "?") host = conn_.host;
+        int node = node_index(host, static_cast<int>(master->element[1]->integer));
+        if (node < 0) {
+            ok = false;
+            break;
+        }
+        for (long long s = e->element[0]->integer; s <= e->element[1]->integer && s < SLOTS; ++s) {
+            map[static_cast<size_t>(s)] = static_cast<int16_t>(node);
+        }
+    }
+    freeReplyObject(reply);
+    if (!ok) return false;
+
+    // Uncovered slots (cluster in reconfiguration) fall back to the seed;
+    // a MOVED reply then corrects them
+    for (auto& n : map) {
+        if (n < 0) n = 0;
+    }
+    slot_node_ = map;
+    return true;
+}
+
+#else
+
+redisContext* redis_open(const std::string&, int, const DbConnection&) { return nullptr; }
+bool RedisCluster::init(redisContext*, const DbConnection&, bool) { return false; }
+bool RedisCluster::refresh() { return false; }
+void RedisCluster::close() { nodes_.clear(); }
+int RedisCluster::node_index(const std::string&, int) { return -1; }
+int RedisCluster::node_by_addr(const std::string&) { return -1; }
+bool RedisCluster::load_slots(redisContext*) { return false; }
+
+#endif
+
+} // namespace dedup
@@ -0,0 +1,76 @@
+#pragma once
+// Redis Cluster topology for slot-aware routing
+//
+// Loads CLUSTER SLOTS from the seed connection and keeps one hiredis context
+// per master. Keys map to masters through the CRC16 hash slot (hash tags
+// honoured). A server with cluster support disabled is treated as a single
+// node that owns every slot, so callers need no separate standalone path.
+//
+// Contexts are not thread-safe: callers drive each node from at most one
+// thread at a time.
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../config.hpp"
+
+struct redisContext;
+
+namespace dedup {
+
+// Connect + AUTH (ACL user or legacy password). nullptr on failure (logged).
+redisContext* redis_open(const std::string& host, int port, const DbConnection& conn);
+
+class RedisCluster {
+public:
+    static constexpr int SLOTS = 16384;
+
+    // CRC16/XMODEM of the key (or of its non-empty {hash tag}) mod 16384
+    [[nodiscard]] static uint16_t key_slot(std::string_view key);
+
+    RedisCluster() = default;
+    ~RedisCluster() { close(); }
+    RedisCluster(const RedisCluster&) = delete;
+    RedisCluster& operator=(const RedisCluster&) = delete;
+
+    // seed: connected context owned by the caller. With use_cluster = false
+    // (or a non-cluster server) everything routes to the seed.
+    bool init(redisContext* seed, const DbConnection& conn, bool use_cluster);
+
+    // Reload CLUSTER SLOTS (after MOVED); keeps contexts of known nodes
+    bool refresh();
+
+    // Frees all contexts except the seed
+    void close();
+
+    [[nodiscard]] bool cluster_mode() const { return cluster_; }
+    [[nodiscard]] size_t node_count() const { return nodes_.size(); }
+    [[nodiscard]] int node_for(std::string_view key) const;
+    [[nodiscard]] redisContext* context(int node) const;
+    [[nodiscard]] std::string node_name(int node) const;
+
+    // Node for "host:port" (ASK target); connects unknown nodes. -1 on failure
+    int node_by_addr(const std::string& addr);
+
+    // Nodes that own at least one slot (SCAN targets)
+    [[nodiscard]] std::vector<int> masters() const;
+
+private:
+    struct Node {
+        std::string host;
+        int port = 0;
+        redisContext* ctx = nullptr;
+        bool owned = false;
+    };
+    std::vector<Node> nodes_;
+    std::array<int16_t, SLOTS> slot_node_{};
+    DbConnection conn_{};
+    redisContext* seed_ = nullptr;
+    bool cluster_ = false;
+
+    int node_index(const std::string& host, int port);
+    bool load_slots(redisContext* from);
+};
+
+} // namespace dedup
@@ -1,7 +1,15 @@
 #include "redis_connector.hpp"
+#include "redis_pipeline.hpp"
 #include "../utils/logger.hpp"
 #include "../utils/timer.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
 #include <filesystem>
+#include <fstream>
+#include <map>
+#include <thread>
 
 #ifdef HAS_HIREDIS
 #include <hiredis/hiredis.h>
@@ -18,40 +26,11 @@ bool RedisConnector::connect(const DbConnection& conn) {
 #endif
 
 #ifdef HAS_HIREDIS
-    struct timeval timeout = {10, 0};
-    auto* c = redisConnectWithTimeout(conn.host.c_str(), conn.port, timeout);
-    if (!c || c->err) {
-        LOG_ERR("[redis] Connection failed: %s", c ? c->errstr : "null context");
-        if (c) redisFree(c);
-        return false;
-    }
+    auto* c = redis_open(conn.host, conn.port, conn);
+    if (!c) return false;
     ctx_ = c;
-
-    // Authenticate if credentials are provided (Redis 6+ ACL)
-    if (!conn.user.empty() && !conn.password.empty()) {
-        auto* auth = static_cast<redisReply*>(
-            redisCommand(c, "AUTH %s %s", conn.user.c_str(), conn.password.c_str()));
-        if (!auth || auth->type == REDIS_REPLY_ERROR) {
-            LOG_ERR("[redis] ACL AUTH failed: %s", auth ? auth->str : "null");
-            if (auth) freeReplyObject(auth);
-            redisFree(c);
-            ctx_ = nullptr;
-            return false;
-        }
-        freeReplyObject(auth);
+    if (!conn.user.empty() && !conn.password.empty())
         LOG_INF("[redis] Authenticated as user '%s'", conn.user.c_str());
-    } else if (!conn.password.empty()) {
-        auto* auth = static_cast<redisReply*>(
-            redisCommand(c, "AUTH %s", conn.password.c_str()));
-        if (!auth || auth->type == REDIS_REPLY_ERROR) {
-            LOG_ERR("[redis] AUTH failed: %s", auth ? auth->str : "null");
-            if (auth) freeReplyObject(auth);
-            redisFree(c);
-            ctx_ = nullptr;
-            return false;
-        }
-        freeReplyObject(auth);
-    }
 
     // Cluster mode: no SELECT, use key-prefix "dedup:" for lab isolation
     // Verify connectivity with PING
@@ -65,8 +44,13 @@ bool RedisConnector::connect(const DbConnection& conn) {
     }
     freeReplyObject(reply);
 
-    LOG_INF("[redis] Connected to %s:%u (cluster mode, key-prefix: %s*)",
-            conn.host.c_str(), conn.port, KEY_PREFIX);
+    // Slot map + one connection per master (standalone: everything to ctx_)
+    cluster_.init(c, conn, tuning_.cluster_routing);
+
+    LOG_INF("[redis] Connected to %s:%u (%s, %zu masters, key-prefix: %s*)",
+            conn.host.c_str(), conn.port,
+            cluster_.cluster_mode() ? "cluster mode" : "standalone",
+            cluster_.masters().size(), KEY_PREFIX);
     connected_ = true;
     return true;
 #else
@@ -78,6 +62,7 @@ bool RedisConnector::connect(const DbConnection& conn) {
 
 void RedisConnector::disconnect() {
 #ifdef HAS_HIREDIS
+    cluster_.close();
     if (ctx_) {
         redisFree(static_cast<redisContext*>(ctx_));
         ctx_ = nullptr;
@@ -106,57 +91,376 @@ bool RedisConnector::reset_lab_schema(const std::string& s) {
     return drop_lab_schema(s);
 }
 
-// SCAN + DEL pattern for cluster-safe key deletion (no FLUSHDB in cluster!)
+// SCAN + UNLINK pattern for cluster-safe key deletion (no FLUSHDB in cluster!)
 int64_t RedisConnector::delete_all_lab_keys() {
 #ifdef HAS_HIREDIS
     if (!ctx_) return -1;
-    auto* c = static_cast<redisContext*>(ctx_);
 
-    int64_t total_deleted = 0;
-    std::string cursor = "0";
-    std::string pattern = std::string(KEY_PREFIX) + "*";
+    MeasureResult r = unlink_lab_keys(false);
+    if (!r.error.empty()) {
+        LOG_ERR("[redis] Lab key cleanup: %s", r.error.c_str());
+        return -1;
+    }
+    LOG_INF("[redis] Deleted %lld lab keys", r.rows_affected);
+    return r.rows_affected;
+#else
+    return -1;
+#endif
+}
 
+bool RedisConnector::scan_node(int node, const ScanFn& fn) {
+#ifdef HAS_HIREDIS
+    // SCAN only sees the keys of the node it runs on
+    const std::string pattern = std::string(KEY_PREFIX) + "*";
+    auto* c = cluster_.context(node);
+    std::vector<std::string> batch;
+    std::string cursor = "0";
     do {
         auto* reply = static_cast<redisReply*>(
             redisCommand(c, "SCAN %s MATCH %s COUNT 1000",
                          cursor.c_str(), pattern.c_str()));
         if (!reply || reply->type != REDIS_REPLY_ARRAY || reply->elements != 2) {
             if (reply) freeReplyObject(reply);
-            LOG_ERR("[redis] SCAN failed");
-            return -1;
+            LOG_ERR("[redis] SCAN failed on %s", cluster_.node_name(node).c_str());
+            return false;
         }
-
         cursor = reply->element[0]->str;
         auto* keys = reply->element[1];
+        batch.clear();
+        for (size_t i = 0; i < keys->elements; i++) {
+            batch.emplace_back(keys->element[i]->str, keys->element[i]->len);
+        }
+        freeReplyObject(reply);
+        if (!batch.empty()) fn(batch);
+    } while (cursor != "0");
+    return true;
+#else
+    (void)node; (void)fn;
+    return false;
+#endif
+}
 
-        if (keys->elements > 0) {
-            // Build DEL command with all found keys
-            std::vector<const char*> argv;
-            std::vector<size_t> argvlen;
-            argv.push_back("DEL");
-            argvlen.push_back(3);
+MeasureResult RedisConnector::run_on_masters(const NodeFn& fn) {
+    MeasureResult total{};
+    const auto nodes = cluster_.masters();
+    if (nodes.size() <= 1) {
+        if (!nodes.empty()) fn(nodes[0], total);
+        return total;
+    }
 
-            for (size_t i = 0; i < keys->elements; i++) {
-                argv.push_back(keys->element[i]->str);
-                argvlen.push_back(keys->element[i]->len);
+    // One thread per master; every worker writes only its own result
+    std::vector<MeasureResult> parts(nodes.size());
+    std::vector<std::thread> threads;
+    threads.reserve(nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        threads.emplace_back([&, i] {
+            int64_t worker_ns = 0;
+            {
+                ScopedTimer st(worker_ns);
+                fn(nodes[i], parts[i]);
             }
+            parts[i].duration_ns = worker_ns;
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    for (auto& part : parts) {
+        total.rows_affected += part.rows_affected;
+        total.bytes_logical += part.bytes_logical;
+        total.per_file_latencies_ns.insert(total.per_file_latencies_ns.end(),
+            part.per_file_latencies_ns.begin(), part.per_file_latencies_ns.end());
+        total.worker_durations_ns.push_back(part.duration_ns);
+        if (!part.error.empty()) {
+            if (!total.error.empty()) total.error += "; ";
+            total.error += part.error;
+        }
+    }
+    return total;
+}
+
+MeasureResult RedisConnector::unlink_lab_keys(bool per_key) {
+    // UNLINK frees values in a background thread; replies carry the number
+    // of keys removed. Keys are deleted while the SCAN of the node proceeds
+    // (no key list is collected), the UNLINKs flushed in pipeline batches.
+    return run_on_masters([&](int node, MeasureResult& part) {
+        MeasureResult replies{};
+        RedisPipeline pipe(cluster_.context(node), tuning_.pipeline_depth,
+                           tuning_.pipeline_bytes, replies, per_key);
+        const size_t batch = tuning_.delete_batch > 1 ? static_cast<size_t>(tuning_.delete_batch) : 1;
+
+        std::vector<const char*> argv;
+        std::vector<size_t> argvlen;
+        auto send = [&](const std::vector<const std::string*>& keys) {
+            argv.assign(1, "UNLINK");
+            argvlen.assign(1, 6);
+            for (const auto* k : keys) {
+                argv.push_back(k->data());
+                argvlen.push_back(k->size());
+            }
+            return pipe.append(static_cast<int>(argv.size()), argv.data(), argvlen.data());
+        };
 
-            auto* del_reply = static_cast<redisReply*>(
-                redisCommandArgv(c, static_cast<int>(argv.size()),
-                                 argv.data(), argvlen.data()));
-            if (del_reply && del_reply->type == REDIS_REPLY_INTEGER) {
-                total_deleted += del_reply->integer;
+        bool ok = scan_node(node, [&](const std::vector<std::string>& keys) {
+            if (per_key) {
+                for (const auto& k : keys) {
+                    if (!send({&k})) return;
+                }
+                return;
             }
-            if (del_reply) freeReplyObject(del_reply);
+            // Multi-key UNLINK must stay within one hash slot in cluster mode
+            // (there, batching mostly degenerates to pipelined single keys)
+            std::map<uint16_t, std::vector<const std::string*>> by_slot;
+            for (const auto& k : keys) {
+                by_slot[cluster_.cluster_mode() ? RedisCluster::key_slot(k) : 0].push_back(&k);
+            }
+            for (auto& [slot, group] : by_slot) {
+                for (size_t i = 0; i < group.size(); i += batch) {
+                    std::vector<const std::string*> chunk(
+                        group.begin() + static_cast<std::ptrdiff_t>(i),
+                        group.begin() + static_cast<std::ptrdiff_t>(std::min(group.size(), i + batch)));
+                    if (!send(chunk)) return;
+                }
+            }
+        });
+        pipe.finish();
+
+        part.rows_affected = pipe.integer_sum();
+        part.per_file_latencies_ns = std::move(replies.per_file_latencies_ns);
+        if (!ok) part.error = "SCAN failed on " + cluster_.node_name(node);
+        if (pipe.errors() > 0 || !pipe.redirects().empty()) {
+            if (!part.error.empty()) part.error += "; ";
+            part.error += std::to_string(pipe.errors() + static_cast<int64_t>(pipe.redirects().size())) +
+                          " UNLINK commands failed on " + cluster_.node_name(node);
         }
+    });
+}
 
-        freeReplyObject(reply);
-    } while (cursor != "0");
+MeasureResult RedisConnector::delete_packed_records(const NativeSchema& ns) {
+#ifdef HAS_HIREDIS
+    // Records are read back per bucket hash (HKEYS) / in XRANGE batches and
+    // deleted through the pipeline; bucket hashes vanish with their last
+    // field, the emptied stream key stays until the schema is dropped.
+    const std::string bucket_prefix = "dedup:" + ns.table_name + ":b";
+    const std::string stream_key = "dedup:" + ns.table_name;
+    const bool stream = encoding_ == Encoding::STREAM;
+    const int range_count = tuning_.delete_batch > 1 ? tuning_.delete_batch : 1000;
+
+    return run_on_masters([&](int node, MeasureResult& part) {
+        auto* c = cluster_.context(node);
+        RedisPipeline pipe(c, tuning_.pipeline_depth, tuning_.pipeline_bytes,
+                           part, tuning_.delete_per_key_latency);
+        std::vector<const char*> argv;
+        std::vector<size_t> argvlen;
+        bool ok = true;
+
+        // Synchronous reads are safe between appends: the pipeline only
+        // writes to the socket when it flushes, and drains every reply then
+        auto delete_bucket = [&](const std::string& key) {
+            auto* reply = static_cast<redisReply*>(
+                redisCommand(c, "HKEYS %b", key.data(), key.size()));
+            if (!reply || reply->type != REDIS_REPLY_ARRAY) {
+                if (reply) freeReplyObject(reply);
+                ok = false;
+                return;
+            }
+            std::map<std::string, std::vector<std::string>> by_record;  // idx -> fields
+            for (size_t i = 0; i < reply->elements; ++i) {
+                std::string field(reply->element[i]->str, reply->element[i]->len);
+                by_record[field.substr(0, field.find('.'))].push_back(std::move(field));
+            }
+            freeReplyObject(reply);
+            for (const auto& [idx, fields] : by_record) {
+                argv.assign({"HDEL", key.data()});
+                argvlen.assign({4, key.size()});
+                for (const auto& f : fields) {
+                    argv.push_back(f.data());
+                    argvlen.push_back(f.size());
+                }
+                if (!pipe.append(static_cast<int>(argv.size()), argv.data(), argvlen.data())) {
+                    ok = false;
+                    return;
+                }
+            }
+        };
+
+        auto delete_stream = [&](const std::string& key) {
+            for (;;) {
+                auto* reply = static_cast<redisReply*>(
+                    redisCommand(c, "XRANGE %b - + COUNT %d", key.data(), key.size(), range_count));
+                if (!reply || reply->type != REDIS_REPLY_ARRAY) {
+                    if (reply) freeReplyObject(reply);
+                    ok = false;
+                    return;
+                }
+                const bool done = reply->elements == 0;
+                const int64_t errors_before = pipe.errors();
+                for (size_t i = 0; i < reply->elements && ok; ++i) {
+                    const auto* id = reply->element[i]->element[0];
+                    const char* xdel[3] = {"XDEL", key.data(), id->str};
+                    const size_t xdel_len[3] = {4, key.size(), id->len};
+                    ok = pipe.append(3, xdel, xdel_len);
+                }
+                freeReplyObject(reply);
+                if (done || !ok) return;
+                // The next XRANGE starts at "-" again: this batch must be gone
+                if (!pipe.flush() || pipe.errors() > errors_before) {
+                    ok = false;
+                    return;
+                }
+            }
+        };
+
+        bool scanned = scan_node(node, [&](const std::vector<std::string>& keys) {
+            for (const auto& key : keys) {
+                if (!ok) return;
+                if (stream) {
+                    if (key == stream_key) delete_stream(key);
+                } else if (key.compare(0, bucket_prefix.size(), bucket_prefix) == 0) {
+                    delete_bucket(key);
+                }
+            }
+        });
+        pipe.finish();
+
+        const char* what = stream ? "XDEL" : "HDEL";
+        if (!scanned || !ok) part.error = std::string(what) + " pass failed on " + cluster_.node_name(node);
+        if (pipe.errors() > 0 || !pipe.redirects().empty()) {
+            if (!part.error.empty()) part.error += "; ";
+            part.error += std::to_string(pipe.errors() + static_cast<int64_t>(pipe.redirects().size())) +
+                          " " + what + " commands failed on " + cluster_.node_name(node);
+        }
+    });
+#else
+    (void)ns;
+    return MeasureResult{};
+#endif
+}
+
+void RedisConnector::run_routed(size_t n_items, const KeyFn& key_of, const SendFn& send,
+                                int depth, bool track_latency, const char* what,
+                                MeasureResult& result) {
+#ifdef HAS_HIREDIS
+    struct Item {
+        size_t idx;
+        bool asking;
+    };
+    struct Part {
+        MeasureResult result;
+        int64_t errors = 0;
+        std::vector<RedisPipeline::Redirect> redirects;
+    };
+
+    std::vector<Item> todo(n_items);
+    for (size_t i = 0; i < n_items; ++i) todo[i] = {i, false};
+    std::map<size_t, std::string> ask_target;  // item -> "host:port"
+    int64_t errors = 0;
+
+    for (int round = 0; !todo.empty(); ++round) {
+        // Group by owning master; order within a node is preserved
+        std::map<int, std::vector<Item>> groups;
+        for (const auto& it : todo) {
+            int node = it.asking ? cluster_.node_by_addr(ask_target[it.idx])
+                                 : cluster_.node_for(key_of(it.idx));
+            if (node < 0) {
+                ++errors;
+                continue;
+            }
+            groups[node].push_back(it);
+        }
+
+        std::vector<int> nodes;
+        for (const auto& [node, items] : groups) nodes.push_back(node);
+        std::vector<Part> parts(nodes.size());
+
+        auto drive = [&](size_t g) {
+            const auto& items = groups.at(nodes[g]);
+            Part& part = parts[g];
+            {
+                RedisPipeline pipe(cluster_.context(nodes[g]), depth, tuning_.pipeline_bytes,
+                                   part.result, track_latency);
+                // Items left behind when the connection fails count as errors
+                int64_t unsent = 0;
+                for (size_t i = 0; i < items.size(); ++i) {
+                    const auto& it = items[i];
+                    if (it.asking) {
+                        const char* argv[1] = {"ASKING"};
+                        const size_t argvlen[1] = {6};
+                        if (!pipe.append_control(1, argv, argvlen)) {
+                            unsent = static_cast<int64_t>(items.size() - i);
+                            break;
+                        }
+                    }
+                    const int64_t errors_before = pipe.errors();
+                    int64_t bytes = send(pipe, it.idx);
+                    if (bytes < 0) {
+                        // A failed flush already counted the queued commands,
+                        // this item's included
+                        unsent = static_cast<int64_t>(items.size() - i) -
+                                 (pipe.errors() > errors_before ? 1 : 0);
+                        break;
+                    }
+                    if (round == 0) part.result.bytes_logical += bytes;
+                }
+                pipe.finish();
+                part.errors = pipe.errors() + unsent;
+                part.redirects = pipe.redirects();
+            }
+        };
+
+        if (nodes.size() == 1) {
+            drive(0);
+        } else {
+            // One thread per master, each on its own connection
+            std::vector<std::thread> threads;
+            threads.reserve(nodes.size());
+            for (size_t g = 0; g < nodes.size(); ++g) {
+                threads.emplace_back([&, g] {
+                    int64_t worker_ns = 0;
+                    {
+                        ScopedTimer st(worker_ns);
+                        drive(g);
+                    }
+                    parts[g].result.duration_ns = worker_ns;
+                });
+            }
+            for (auto& t : threads) t.join();
+        }
+
+        todo.clear();
+        bool moved = false;
+        for (auto& part : parts) {
+            result.rows_affected += part.result.rows_affected;
+            result.bytes_logical += part.result.bytes_logical;
+            result.per_file_latencies_ns.insert(result.per_file_latencies_ns.end(),
+                part.result.per_file_latencies_ns.begin(), part.result.per_file_latencies_ns.end());
+            if (round == 0 && nodes.size() > 1)
+                result.worker_durations_ns.push_back(part.result.duration_ns);
+            errors += part.errors;
+            for (const auto& r : part.redirects) {
+                todo.push_back({r.tag, r.ask});
+                if (r.ask) ask_target[r.tag] = r.addr;
+                else moved = true;
+            }
+        }
+        if (todo.empty()) break;
+
+        if (round >= tuning_.max_redirects) {
+            LOG_ERR("[redis] %zu %s commands still redirected after %d rounds",
+                todo.size(), what, round + 1);
+            errors += static_cast<int64_t>(todo.size());
+            break;
+        }
+        // MOVED = slot ownership changed for good; ASK only for this command
+        LOG_INF("[redis] %zu %s commands redirected, retrying", todo.size(), what);
+        if (moved) cluster_.refresh();
+    }
 
-    LOG_INF("[redis] Deleted %lld lab keys", total_deleted);
-    return total_deleted;
+    if (errors > 0) {
+        result.error = std::to_string(errors) + " " + what + " commands failed";
+    }
 #else
-    return -1;
+    (void)n_items; (void)key_of; (void)send; (void)depth; (void)track_latency;
+    (void)what; (void)result;
 #endif
 }
 
@@ -174,25 +478,7 @@ MeasureResult RedisConnector::bulk_insert(const std::string& data_dir, DupGrade
 #ifdef HAS_HIREDIS
     Timer timer;
     timer.start();
-    auto* c = static_cast<redisContext*>(ctx_);
-
-    for (const auto& entry : fs::directory_iterator(dir)) {
-        if (!entry.is_regular_file()) continue;
-        auto fsize = entry.file_size();
-        std::ifstream f(entry.path(), std::ios::binary);
-        std::vector<char> buf(fsize);
-        f.read(buf.data(), static_cast<std::streamsize>(fsize));
-
-        std::string key = std::string(KEY_PREFIX) + entry.path().filename().string();
-        auto* reply = static_cast<redisReply*>(
-            redisCommand(c, "SET %s %b", key.c_str(), buf.data(), fsize));
-        if (reply) {
-            result.rows_affected++;
-            freeReplyObject(reply);
-        }
-        result.bytes_logical += fsize;
-    }
-
+    load_files(dir, result, false);
     timer.stop();
     result.duration_ns = timer.elapsed_ns();
     LOG_INF("[redis] Bulk insert: %lld keys, %lld bytes, %lld ms",
@@ -215,31 +501,7 @@ MeasureResult RedisConnector::perfile_insert(const std::string& data_dir, DupGra
 #ifdef HAS_HIREDIS
     Timer total_timer;
     total_timer.start();
-    auto* c = static_cast<redisContext*>(ctx_);
-
-    for (const auto& entry : fs::directory_iterator(dir)) {
-        if (!entry.is_regular_file()) continue;
-        auto fsize = entry.file_size();
-        std::ifstream f(entry.path(), std::ios::binary);
-        std::vector<char> buf(fsize);
-        f.read(buf.data(), static_cast<std::streamsize>(fsize));
-
-        std::string key = std::string(KEY_PREFIX) + entry.path().filename().string();
-
-        int64_t set_ns = 0;
-        {
-            ScopedTimer st(set_ns);
-            auto* reply = static_cast<redisReply*>(
-                redisCommand(c, "SET %s %b", key.c_str(), buf.data(), fsize));
-            if (reply) {
-                result.rows_affected++;
-                freeReplyObject(reply);
-            }
-        }
-        result.per_file_latencies_ns.push_back(set_ns);
-        result.bytes_logical += fsize;
-    }
-
+    load_files(dir, result, true);
     total_timer.stop();
     result.duration_ns = total_timer.elapsed_ns();
     LOG_INF("[redis] Per-file insert: %lld keys, %lld bytes, %lld ms",
@@ -248,6 +510,44 @@ MeasureResult RedisConnector::perfile_insert(const std::string& data_dir, DupGra
     return result;
 }
 
+void RedisConnector::load_files(const std::string& dir, MeasureResult& result,
+                                bool track_latency) {
+#ifdef HAS_HIREDIS
+    if (!ctx_) {
+        result.error = "not connected";
+        return;
+    }
+    std::vector<fs::path> files;
+    for (const auto& entry : fs::directory_iterator(dir)) {
+        if (entry.is_regular_file()) files.push_back(entry.path());
+    }
+    std::sort(files.begin(), files.end());
+
+    auto key_of = [&](size_t i) {
+        return std::string(KEY_PREFIX) + files[i].filename().string();
+    };
+    run_routed(files.size(), key_of,
+        [&](RedisPipeline& pipe, size_t i) -> int64_t {
+            auto fsize = fs::file_size(files[i]);
+            std::ifstream f(files[i], std::ios::binary);
+            std::vector<char> buf(fsize);
+            f.read(buf.data(), static_cast<std::streamsize>(fsize));
+            // The value goes out by reference: the pipeline holds the buffer
+            // until its batch is written
+            const char* value = pipe.retain(std::move(buf));
+
+            std::string key = key_of(i);
+            const char* argv[3] = {"SET", key.c_str(), value};
+            const size_t argvlen[3] = {3, key.size(), fsize};
+            if (!pipe.append(3, argv, argvlen, i)) return -1;
+            return static_cast<int64_t>(fsize);
+        },
+        tuning_.pipeline_depth, track_latency, "SET", result);
+#else
+    (void)dir; (void)result; (void)track_latency;
+#endif
+}
+
 MeasureResult RedisConnector::perfile_delete() {
     MeasureResult result{};
     LOG_INF("[redis] Deleting all lab keys individually (prefix: %s*)", KEY_PREFIX);
@@ -257,53 +557,19 @@ MeasureResult RedisConnector::perfile_delete() {
 #endif
 #ifdef HAS_HIREDIS
     if (!ctx_) return result;
-    auto* c = static_cast<redisContext*>(ctx_);
 
     Timer total_timer;
     total_timer.start();
 
-    // Collect all lab keys first
-    std::vector<std::string> all_keys;
-    std::string cursor = "0";
-    std::string pattern = std::string(KEY_PREFIX) + "*";
-
-    do {
-        auto* reply = static_cast<redisReply*>(
-            redisCommand(c, "SCAN %s MATCH %s COUNT 1000",
-                         cursor.c_str(), pattern.c_str()));
-        if (!reply || reply->type != REDIS_REPLY_ARRAY || reply->elements != 2) {
-            if (reply) freeReplyObject(reply);
-            break;
-        }
-        cursor = reply->element[0]->str;
-        auto* keys = reply->element[1];
-        for (size_t i = 0; i < keys->elements; i++) {
-            all_keys.emplace_back(keys->element[i]->str, keys->element[i]->len);
-        }
-        freeReplyObject(reply);
-    } while (cursor != "0");
-
-    LOG_INF("[redis] Deleting %zu keys individually", all_keys.size());
-
-    // Delete each key individually with latency tracking
-    for (const auto& key : all_keys) {
-        int64_t del_ns = 0;
-        {
-            ScopedTimer st(del_ns);
-            auto* reply = static_cast<redisReply*>(
-                redisCommand(c, "DEL %s", key.c_str()));
-            if (reply && reply->type == REDIS_REPLY_INTEGER && reply->integer > 0) {
-                result.rows_affected++;
-            }
-            if (reply) freeReplyObject(reply);
-        }
-        result.per_file_latencies_ns.push_back(del_ns);
-    }
+    // Stream SCAN batches into pipelined UNLINKs on every master. Per-key
+    // mode keeps one command (and latency sample) per key for Stage 3.
+    result = unlink_lab_keys(tuning_.delete_per_key_latency);
 
     total_timer.stop();
     result.duration_ns = total_timer.elapsed_ns();
-    LOG_INF("[redis] Per-key delete: %lld keys, %lld ms",
-        result.rows_affected, total_timer.elapsed_ms());
+    LOG_INF("[redis] Per-key delete: %lld keys, %lld ms (%s)",
+        result.rows_affected, total_timer.elapsed_ms(),
+        tuning_.delete_per_key_latency ? "UNLINK per key" : "batched UNLINK");
 #endif
     return result;
 }
@@ -320,50 +586,117 @@ int64_t RedisConnector::get_logical_size_bytes() {
 #endif
 #ifdef HAS_HIREDIS
     if (!ctx_) return -1;
-    auto* c = static_cast<redisContext*>(ctx_);
-
-    // Count lab keys using SCAN (cluster-safe) and sum their sizes
-    int64_t total_bytes = 0;
-    int64_t key_count = 0;
-    std::string cursor = "0";
-    std::string pattern = std::string(KEY_PREFIX) + "*";
 
-    do {
-        auto* reply = static_cast<redisReply*>(
-            redisCommand(c, "SCAN %s MATCH %s COUNT 1000",
-                         cursor.c_str(), pattern.c_str()));
-        if (!reply || reply->type != REDIS_REPLY_ARRAY || reply->elements != 2) {
-            if (reply) freeReplyObject(reply);
-            return -1;
+    // MEMORY USAGE covers strings and native hashes alike. Sample keys
+    // deterministically and raise the rate until the estimate is within the
+    // error bound (the final fallback, rate 1.0, is exact).
+    double rate = std::clamp(tuning_.size_sample_rate, 1e-6, 1.0);
+    for (;;) {
+        SizeSample smp;
+        if (!sample_memory_usage(rate, smp)) return -1;
+
+        if (smp.sampled >= smp.keys) {
+            LOG_INF("[redis] Lab key count: %lld, memory usage: %lld bytes (all keys)",
+                smp.keys, smp.sum);
+            return smp.sum;
+        }
+        if (smp.sampled < MIN_SIZE_SAMPLES && rate < 1.0) {
+            // Too few keys for the variance to mean anything (one key, or a
+            // few of equal size, would pass any bound): sample more first
+            double next = rate * 1.2 * MIN_SIZE_SAMPLES / std::max<double>(smp.sampled, 1.0);
+            rate = next >= 0.5 ? 1.0 : next;
+            LOG_DBG("[redis] Only %lld keys sampled, resampling at rate %.4f",
+                smp.sampled, rate);
+            continue;
         }
 
-        cursor = reply->element[0]->str;
-        auto* keys = reply->element[1];
-
-        for (size_t i = 0; i < keys->elements; i++) {
-            key_count++;
-            // Get string length for each key
-            auto* len_reply = static_cast<redisReply*>(
-                redisCommand(c, "STRLEN %s", keys->element[i]->str));
-            if (len_reply && len_reply->type == REDIS_REPLY_INTEGER) {
-                total_bytes += len_reply->integer;
-            }
-            if (len_reply) freeReplyObject(len_reply);
+        // Ratio estimator with finite population correction, 95% interval
+        const double n = static_cast<double>(smp.sampled);
+        const double N = static_cast<double>(smp.keys);
+        const double mean = static_cast<double>(smp.sum) / n;
+        const double var = n > 1 ? (smp.sum_sq - n * mean * mean) / (n - 1) : 0.0;
+        const double estimate = N * mean;
+        const double half_width = 1.96 * N * std::sqrt(std::max(var, 0.0) / n * (1.0 - n / N));
+        const double rel_err = estimate > 0 ? half_width / estimate : 0.0;
+
+        if (rel_err <= tuning_.size_error_bound || rate >= 1.0) {
+            LOG_INF("[redis] Lab key count: %lld, memory usage: ~%.0f bytes "
+                    "(%lld keys sampled, +/-%.2f%%)",
+                smp.keys, estimate, smp.sampled, rel_err * 100.0);
+            return static_cast<int64_t>(estimate);
         }
+        // Error shrinks with sqrt(n): scale the rate to hit the bound
+        const double ratio = rel_err / std::max(tuning_.size_error_bound, 1e-9);
+        double next = rate * ratio * ratio * 1.2;
+        rate = next >= 0.5 ? 1.0 : next;
+        LOG_DBG("[redis] Size estimate +/-%.2f%% > bound, resampling at rate %.4f",
+            rel_err * 100.0, rate);
+    }
+#else
+    return -1;
+#endif
+}
 
-        freeReplyObject(reply);
-    } while (cursor != "0");
+bool RedisConnector::sample_memory_usage(double rate, SizeSample& out) {
+#ifdef HAS_HIREDIS
+    std::vector<SizeSample> per_node(cluster_.node_count());
+    std::vector<int> nodes = cluster_.masters();
+    std::string samples = std::to_string(tuning_.memory_usage_samples);
+
+    MeasureResult r = run_on_masters([&](int node, MeasureResult& part) {
+        MeasureResult replies{};
+        RedisPipeline pipe(cluster_.context(node), tuning_.pipeline_depth,
+                           tuning_.pipeline_bytes, replies, false);
+        SizeSample& smp = per_node[static_cast<size_t>(node)];
+        bool ok = scan_node(node, [&](const std::vector<std::string>& keys) {
+            for (const auto& k : keys) {
+                smp.keys++;
+                if (!key_sampled(k, rate)) continue;
+                const char* argv[5] = {"MEMORY", "USAGE", k.data(), "SAMPLES", samples.c_str()};
+                const size_t argvlen[5] = {6, 5, k.size(), 7, samples.size()};
+                if (!pipe.append(5, argv, argvlen)) return;
+            }
+        });
+        pipe.finish();
+        smp.sampled = pipe.integer_count();
+        smp.sum = pipe.integer_sum();
+        smp.sum_sq = pipe.integer_sum_sq();
+        if (!ok || pipe.errors() > 0) part.error = "MEMORY USAGE failed on " + cluster_.node_name(node);
+    });
+    if (!r.error.empty()) {
+        LOG_ERR("[redis] Size probe: %s", r.error.c_str());
+        return false;
+    }
 
-    LOG_INF("[redis] Lab key count: %lld, total value bytes: %lld", key_count, total_bytes);
-    return total_bytes;
+    out = {};
+    for (int node : nodes) {
+        const auto& smp = per_node[static_cast<size_t>(node)];
+        out.keys += smp.keys;
+        out.sampled += smp.sampled;
+        out.sum += smp.sum;
+        out.sum_sq += smp.sum_sq;
+    }
+    return true;
 #else
-    return -1;
+    (void)rate; (void)out;
+    return false;
 #endif
 }
 
+bool RedisConnector::key_sampled(const std::string& key, double rate) {
+    if (rate >= 1.0) return true;
+    // FNV-1a: the same keys are picked in every run, and a higher rate
+    // picks a superset of a lower one
+    uint64_t h = 14695981039346656037ULL;
+    for (unsigned char c : key) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    return static_cast<double>(h >> 11) * 0x1.0p-53 < rate;
+}
 
 // ============================================================================
-// Native insertion mode (Stage 1) -- Redis HSET for structured data
+// Native insertion mode (Stage 1) -- HSET, JSON SET or XADD per record
 // ============================================================================
 
 bool RedisConnector::create_native_schema(const std::string& schema_name, PayloadType type) {
@@ -389,51 +722,9 @@ MeasureResult RedisConnector::native_bulk_insert(
 #endif
 
 #ifdef HAS_HIREDIS
-    auto ns = get_native_schema(type);
-    std::string prefix = "dedup:" + ns.table_name + ":";
-
     Timer timer;
     timer.start();
-
-    int64_t idx = 0;
-    for (const auto& rec : records) {
-        // Build HSET command: HSET prefix:idx field1 val1 field2 val2 ...
-        std::vector<std::string> args = {"HSET", prefix + std::to_string(idx)};
-
-        for (const auto& [col_name, val] : rec.columns) {
-            args.push_back(col_name);
-            std::visit([&](const auto& v) {
-                using T = std::decay_t<decltype(v)>;
-                if constexpr (std::is_same_v<T, std::monostate>) args.push_back("");
-                else if constexpr (std::is_same_v<T, bool>) args.push_back(v ? "1" : "0");
-                else if constexpr (std::is_same_v<T, int64_t>) args.push_back(std::to_string(v));
-                else if constexpr (std::is_same_v<T, double>) args.push_back(std::to_string(v));
-                else if constexpr (std::is_same_v<T, std::string>) args.push_back(v);
-                else if constexpr (std::is_same_v<T, std::vector<char>>) {
-                    args.push_back(std::string(v.begin(), v.end()));
-                }
-            }, val);
-        }
-
-        // Execute HSET via hiredis
-        std::vector<const char*> argv;
-        std::vector<size_t> argvlen;
-        for (const auto& a : args) {
-            argv.push_back(a.c_str());
-            argvlen.push_back(a.size());
-        }
-
-        redisReply* reply = static_cast<redisReply*>(
-            redisCommandArgv(static_cast<redisContext*>(ctx_),
-                static_cast<int>(argv.size()), argv.data(), argvlen.data()));
-        if (reply) {
-            result.rows_affected++;
-            freeReplyObject(reply);
-        }
-        result.bytes_logical += static_cast<int64_t>(rec.estimated_size_bytes());
-        idx++;
-    }
-
+    load_native(records, type, result, false);
     timer.stop();
     result.duration_ns = timer.elapsed_ns();
     LOG_INF("[redis] Native bulk insert: %lld rows, %lld ms",
@@ -453,66 +744,242 @@ MeasureResult RedisConnector::native_perfile_insert(
 #endif
 
 #ifdef HAS_HIREDIS
-    auto ns = get_native_schema(type);
-    std::string prefix = "dedup:" + ns.table_name + ":";
-
     Timer total_timer;
     total_timer.start();
+    load_native(records, type, result, true);
+    total_timer.stop();
+    result.duration_ns = total_timer.elapsed_ns();
+#else
+    result.error = "Redis not compiled";
+#endif
+    return result;
+}
 
-    int64_t idx = 0;
-    for (const auto& rec : records) {
-        std::vector<std::string> args = {"HSET", prefix + std::to_string(idx)};
-        for (const auto& [col_name, val] : rec.columns) {
-            args.push_back(col_name);
-            std::visit([&](const auto& v) {
-                using T = std::decay_t<decltype(v)>;
-                if constexpr (std::is_same_v<T, std::monostate>) args.push_back("");
-                else if constexpr (std::is_same_v<T, bool>) args.push_back(v ? "1" : "0");
-                else if constexpr (std::is_same_v<T, int64_t>) args.push_back(std::to_string(v));
-                else if constexpr (std::is_same_v<T, double>) args.push_back(std::to_string(v));
-                else if constexpr (std::is_same_v<T, std::string>) args.push_back(v);
-                else if constexpr (std::is_same_v<T, std::vector<char>>) {
-                    args.push_back(std::string(v.begin(), v.end()));
-                }
-            }, val);
-        }
+bool RedisConnector::select_variant(const std::string& name) {
+    if (name.empty() || name == "hash") {
+        encoding_ = Encoding::HASH;
+    } else if (name == "listpack") {
+        encoding_ = Encoding::LISTPACK;
+        listpack_entries_ = listpack_limit();
+    } else if (name == "json") {
+        encoding_ = Encoding::JSON;
+    } else if (name == "stream") {
+        encoding_ = Encoding::STREAM;
+    } else {
+        LOG_ERR("[redis] Unknown native encoding %s (hash|listpack|json|stream)", name.c_str());
+        return false;
+    }
+    encoding_name_ = name;
+    if (!name.empty()) {
+        if (encoding_ == Encoding::LISTPACK)
+            LOG_INF("[redis] Native encoding listpack: %d fields per bucket hash", listpack_entries_);
+        else
+            LOG_INF("[redis] Native encoding %s", name.c_str());
+    }
+    return true;
+}
 
-        std::vector<const char*> argv;
-        std::vector<size_t> argvlen;
-        for (const auto& a : args) {
-            argv.push_back(a.c_str());
-            argvlen.push_back(a.size());
-        }
+int RedisConnector::listpack_limit() {
+    int limit = tuning_.listpack_entries;
+#ifdef HAS_HIREDIS
+    if (!ctx_) return limit;
+    auto* c = static_cast<redisContext*>(ctx_);
+    // Redis < 7 only knows the ziplist name of the same setting
+    for (const char* param : {"hash-max-listpack-entries", "hash-max-ziplist-entries"}) {
+        auto* reply = static_cast<redisReply*>(redisCommand(c, "CONFIG GET %s", param));
+        // RESP2: [name, value], RESP3: {name: value} -- same element layout
+        bool found = reply && (reply->type == REDIS_REPLY_ARRAY || reply->type == REDIS_REPLY_MAP) &&
+                     reply->elements >= 2 && reply->element[1]->str;
+        if (found) limit = std::atoi(reply->element[1]->str);
+        if (reply) freeReplyObject(reply);
+        if (found) return limit;
+    }
+    LOG_WRN("[redis] CONFIG GET hash-max-listpack-entries failed, assuming %d", limit);
+#endif
+    return limit;
+}
 
-        int64_t insert_ns = 0;
-        {
-            ScopedTimer st(insert_ns);
-            redisReply* reply = static_cast<redisReply*>(
-                redisCommandArgv(static_cast<redisContext*>(ctx_),
-                    static_cast<int>(argv.size()), argv.data(), argvlen.data()));
-            if (reply) {
-                result.rows_affected++;
-                freeReplyObject(reply);
-            }
+#ifdef HAS_HIREDIS
+namespace {
+
+std::string base64_encode(const std::vector<char>& in) {
+    static const char* const TABLE =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    out.reserve((in.size() + 2) / 3 * 4);
+    size_t i = 0;
+    for (; i + 2 < in.size(); i += 3) {
+        uint32_t n = (static_cast<uint8_t>(in[i]) << 16) |
+                     (static_cast<uint8_t>(in[i + 1]) << 8) | static_cast<uint8_t>(in[i + 2]);
+        out += TABLE[(n >> 18) & 63];
+        out += TABLE[(n >> 12) & 63];
+        out += TABLE[(n >> 6) & 63];
+        out += TABLE[n & 63];
+    }
+    if (i < in.size()) {
+        uint32_t n = static_cast<uint8_t>(in[i]) << 16;
+        if (i + 1 < in.size()) n |= static_cast<uint8_t>(in[i + 1]) << 8;
+        out += TABLE[(n >> 18) & 63];
+        out += TABLE[(n >> 12) & 63];
+        out += (i + 1 < in.size()) ? TABLE[(n >> 6) & 63] : '=';
+        out += '=';
+    }
+    return out;
+}
+
+// One record as a JSON document; binary columns base64-encoded
+std::string record_json(const NativeRecord& rec) {
+    nlohmann::json doc = nlohmann::json::object();
+    for (const auto& [col_name, val] : rec.columns) {
+        std::visit([&](const auto& v) {
+            using T = std::decay_t<decltype(v)>;
+            if constexpr (std::is_same_v<T, std::monostate>) doc[col_name] = nullptr;
+            else if constexpr (std::is_same_v<T, std::vector<char>>) doc[col_name] = base64_encode(v);
+            else doc[col_name] = v;
+        }, val);
+    }
+    // Text columns are not guaranteed to be valid UTF-8
+    return doc.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+}
+
+void put_value(RespWriter& w, const ColumnValue& val) {
+    std::visit([&](const auto& v) {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<T, std::monostate>) w.arg("", 0);
+        else if constexpr (std::is_same_v<T, bool>) w.arg(v ? "1" : "0", 1);
+        else if constexpr (std::is_same_v<T, int64_t>) w.arg_int(v);
+        else if constexpr (std::is_same_v<T, double>) w.arg_double(v);
+        else if constexpr (std::is_same_v<T, std::string>) w.arg(v);
+        else if constexpr (std::is_same_v<T, std::vector<char>>) w.arg(v.data(), v.size());
+    }, val);
+}
+
+} // namespace
+#endif
+
+void RedisConnector::load_native(const std::vector<NativeRecord>& records, PayloadType type,
+                                 MeasureResult& result, bool track_latency) {
+#ifdef HAS_HIREDIS
+    if (!ctx_) {
+        result.error = "not connected";
+        return;
+    }
+    auto ns = get_native_schema(type);
+    const std::string prefix = "dedup:" + ns.table_name + ":";
+    const std::string stream_key = "dedup:" + ns.table_name;
+
+    // listpack: whole records per bucket, fields kept below the server limit
+    // (values above hash-max-listpack-value still convert the bucket)
+    const size_t ncols = std::max<size_t>(1, ns.columns.size());
+    const size_t bucket_records =
+        std::max<size_t>(1, static_cast<size_t>(std::max(listpack_entries_, 1)) / ncols);
+
+    const Encoding enc = encoding_;
+    auto key_of = [&](size_t i) -> std::string {
+        switch (enc) {
+            case Encoding::LISTPACK: return prefix + "b" + std::to_string(i / bucket_records);
+            case Encoding::STREAM:   return stream_key;
+            default:                 return prefix + std::to_string(i);
         }
-        result.per_file_latencies_ns.push_back(insert_ns);
-        result.bytes_logical += static_cast<int64_t>(rec.estimated_size_bytes());
-        idx++;
+    };
+    const char* what = enc == Encoding::JSON ? "SET" : enc == Encoding::STREAM ? "XADD" : "HSET";
+
+    run_routed(records.size(), key_of,
+        [&](RedisPipeline& pipe, size_t i) -> int64_t {
+            const auto& rec = records[i];
+            const std::string key = key_of(i);
+            const int ncol = static_cast<int>(rec.columns.size());
+            // Commands are encoded straight from the record: strings and
+            // binary columns are referenced (records outlive the pipeline),
+            // numbers formatted in place
+            switch (enc) {
+                case Encoding::HASH: {
+                    // HSET prefix:idx field1 val1 field2 val2 ...
+                    auto& w = pipe.begin_command(2 + 2 * ncol);
+                    w.arg("HSET");
+                    w.arg(key);
+                    for (const auto& [col_name, val] : rec.columns) {
+                        w.arg(col_name);
+                        put_value(w, val);
+                    }
+                    break;
+                }
+                case Encoding::LISTPACK: {
+                    // HSET prefix:b<bucket> <idx>.field1 val1 ...
+                    auto& w = pipe.begin_command(2 + 2 * ncol);
+                    w.arg("HSET");
+                    w.arg(key);
+                    const std::string field_prefix = std::to_string(i) + ".";
+                    for (const auto& [col_name, val] : rec.columns) {
+                        w.arg(field_prefix + col_name);
+                        put_value(w, val);
+                    }
+                    break;
+                }
+                case Encoding::JSON: {
+                    // SET prefix:idx <document>
+                    std::string doc = record_json(rec);
+                    const size_t len = doc.size();
+                    const char* data = pipe.retain(std::move(doc));
+                    auto& w = pipe.begin_command(3);
+                    w.arg("SET");
+                    w.arg(key);
+                    w.arg(data, len);
+                    break;
+                }
+                case Encoding::STREAM: {
+                    // XADD dedup:<table> * field1 val1 ...
+                    auto& w = pipe.begin_command(3 + 2 * ncol);
+                    w.arg("XADD");
+                    w.arg(key);
+                    w.arg("*");
+                    for (const auto& [col_name, val] : rec.columns) {
+                        w.arg(col_name);
+                        put_value(w, val);
+                    }
+                    break;
+                }
+            }
+            if (!pipe.end_command(i)) return -1;
+            return static_cast<int64_t>(rec.estimated_size_bytes());
+        },
+        tuning_.pipeline_depth, track_latency, what, result);
+#else
+    (void)records; (void)type; (void)result; (void)track_latency;
+#endif
+}
+
+MeasureResult RedisConnector::native_perfile_delete(PayloadType type) {
+    // hash / json: one key per record, same as the BLOB delete
+    if (encoding_ != Encoding::LISTPACK && encoding_ != Encoding::STREAM) {
+        return perfile_delete();
     }
 
+    MeasureResult result{};
+    LOG_INF("[redis] Deleting native %s records individually", encoding_name_.c_str());
+#ifdef DEDUP_DRY_RUN
+    LOG_INF("[redis] DRY RUN: would delete native records individually");
+    return result;
+#endif
+#ifdef HAS_HIREDIS
+    if (!ctx_) return result;
+
+    Timer total_timer;
+    total_timer.start();
+
+    result = delete_packed_records(get_native_schema(type));
+
     total_timer.stop();
     result.duration_ns = total_timer.elapsed_ns();
+    LOG_INF("[redis] Per-record delete: %lld records, %lld ms (%s)",
+        result.rows_affected, total_timer.elapsed_ms(),
+        encoding_ == Encoding::STREAM ? "XDEL per entry" : "HDEL per record");
 #else
-    result.error = "Redis not compiled";
+    (void)type;
 #endif
     return result;
 }
 
-MeasureResult RedisConnector::native_perfile_delete(PayloadType type) {
-    // Same as BLOB delete -- scan and delete all dedup: keys
-    return perfile_delete();
-}
-
 int64_t RedisConnector::get_native_logical_size_bytes(PayloadType type) {
     return get_logical_size_bytes();
 }
@@ -1,12 +1,26 @@
 #pragma once
 #include "db_connector.hpp"
+#include "redis_cluster.hpp"
+#include "redis_pipeline.hpp"
+#include <functional>
 
 namespace dedup {
 
 // Redis connector -- uses key-prefix for lab isolation (cluster mode, no SELECT)
 // All lab keys use prefix "dedup:" -- production keys have NO such prefix.
+// Load stages (SET / native HSET) go through RedisPipeline with
+// RedisTuning::pipeline_depth commands per flush.
+// In cluster mode keys are routed by hash slot (RedisCluster): one pipeline
+// and thread per master, MOVED/ASK replies re-routed after a topology
+// refresh. SCAN-based delete and sizing walk every master: deletes are
+// pipelined UNLINKs, the size probe is a sampled, pipelined MEMORY USAGE.
+// Commands are RESP-encoded by RespWriter: file buffers and native record
+// columns go to the socket via writev() without a user-space copy.
+// Native mode runs once per RedisTuning::native_encodings entry (hash,
+// listpack, json, stream), selected through the variant interface.
 class RedisConnector : public DbConnector {
 public:
+    explicit RedisConnector(const RedisTuning& tuning = {}) : tuning_(tuning) {}
     ~RedisConnector() override { disconnect(); }
 
     bool connect(const DbConnection& conn) override;
@@ -36,9 +50,77 @@ public:
     MeasureResult native_perfile_delete(PayloadType type) override;
     int64_t get_native_logical_size_bytes(PayloadType type) override;
 
+    // Native record encodings (RedisTuning::native_encodings, native mode only)
+    [[nodiscard]] std::vector<std::string> native_variants() const override {
+        return tuning_.native_encodings;
+    }
+    bool select_variant(const std::string& name) override;
+    [[nodiscard]] std::string current_variant() const override { return encoding_name_; }
+
 private:
     static constexpr const char* KEY_PREFIX = "dedup:";
-    int64_t delete_all_lab_keys();  // SCAN + DEL for dedup:* keys
+    int64_t delete_all_lab_keys();  // SCAN + UNLINK for dedup:* keys
+
+    // Routing key of work item i / queue its command (tagged i) on the
+    // pipeline and return its logical bytes, -1 to stop
+    using KeyFn = std::function<std::string(size_t item)>;
+    using SendFn = std::function<int64_t(RedisPipeline& pipe, size_t item)>;
+    // Sends n_items commands grouped by master (one thread per node when
+    // there are several), retrying redirects up to RedisTuning::max_redirects.
+    // Worker wall times go to worker_durations_ns.
+    void run_routed(size_t n_items, const KeyFn& key_of, const SendFn& send,
+                    int depth, bool track_latency, const char* what, MeasureResult& result);
+
+    // SCAN dedup:* on one master; fn gets one batch of keys at a time
+    using ScanFn = std::function<void(const std::vector<std::string>& keys)>;
+    bool scan_node(int node, const ScanFn& fn);
+
+    // Runs fn once per master (one thread each when there are several) and
+    // merges the per-node results; worker wall times go to worker_durations_ns.
+    using NodeFn = std::function<void(int node, MeasureResult& part)>;
+    MeasureResult run_on_masters(const NodeFn& fn);
+
+    // SCAN + pipelined UNLINK of all lab keys; rows_affected = keys removed.
+    // per_key: one UNLINK (and latency sample) per key, else delete_batch keys
+    MeasureResult unlink_lab_keys(bool per_key);
+
+    // Native Stage 3 for encodings that pack several records into one key:
+    // listpack = one HDEL of a record's <idx>.* fields, stream = one XDEL
+    // per entry; rows_affected and latency samples are per record
+    MeasureResult delete_packed_records(const NativeSchema& schema);
+
+    // Pipelined MEMORY USAGE over the keys picked by key_sampled(rate)
+    struct SizeSample {
+        int64_t keys = 0;     // lab keys scanned
+        int64_t sampled = 0;  // keys measured
+        int64_t sum = 0;      // bytes of the measured keys
+        double sum_sq = 0;
+    };
+    bool sample_memory_usage(double rate, SizeSample& out);
+    // Smallest sample the error estimate is trusted for; below it the rate
+    // is raised (up to 1.0, every key)
+    static constexpr int64_t MIN_SIZE_SAMPLES = 30;
+    static bool key_sampled(const std::string& key, double rate);
+
+    // SET every file of `dir` (per-key latencies only if track_latency)
+    void load_files(const std::string& dir, MeasureResult& result, bool track_latency);
+    // One command per record in the selected encoding:
+    //   hash     HSET dedup:<table>:<idx> col val ...
+    //   listpack HSET dedup:<table>:b<bucket> <idx>.col val ... (bucket_records
+    //            records per key, below hash-max-listpack-entries fields)
+    //   json     SET dedup:<table>:<idx> {"col":val,...}
+    //   stream   XADD dedup:<table> * col val ...
+    void load_native(const std::vector<NativeRecord>& records, PayloadType type,
+                     MeasureResult& result, bool track_latency);
+    // Server hash-max-listpack-entries (CONFIG GET), else tuning_.listpack_entries
+    int listpack_limit();
+
+    enum class Encoding { HASH, LISTPACK, JSON, STREAM };
+    Encoding encoding_ = Encoding::HASH;
+    std::string encoding_name_;  // "" = default (hash)
+    int listpack_entries_ = 0;   // resolved when "listpack" is selected
+    RedisTuning tuning_;
+    RedisCluster cluster_;
     void* ctx_ = nullptr;  // redisContext* or raw socket
     bool connected_ = false;
 };
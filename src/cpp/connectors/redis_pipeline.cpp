@@ -0,0 +1,139 @@
+#include "redis_pipeline.hpp"
+#include "../utils/logger.hpp"
+#include <cstring>
+
+#ifdef HAS_HIREDIS
+#include <hiredis/hiredis.h>
+#endif
+
+namespace dedup {
+
+#ifdef HAS_HIREDIS
+
+bool RedisPipeline::append(int argc, const char** argv, const size_t* argvlen, size_t tag) {
+    writer_.command(argc);
+    for (int i = 0; i < argc; ++i) writer_.arg(argv[i], argvlen[i]);
+    return queue({tag, true});
+}
+
+bool RedisPipeline::append_control(int argc, const char** argv, const size_t* argvlen) {
+    writer_.command(argc);
+    for (int i = 0; i < argc; ++i) writer_.arg(argv[i], argvlen[i]);
+    return queue({0, false});
+}
+
+RespWriter& RedisPipeline::begin_command(int argc) {
+    writer_.command(argc);
+    return writer_;
+}
+
+bool RedisPipeline::end_command(size_t tag) {
+    return queue({tag, true});
+}
+
+const char* RedisPipeline::retain(std::vector<char> buf) {
+    retained_.push_back(std::move(buf));
+    return retained_.back().data();
+}
+const char* RedisPipeline::retain(std::string buf) {
+    retained_str_.push_back(std::move(buf));
+    return retained_str_.back().data();
+}
+
+bool RedisPipeline::queue(Pending p) {
+    if (!ctx_) {
+        writer_.clear();
+        return false;
+    }
+    pending_.push_back(p);
+    if (static_cast<int>(pending_.size()) >= depth_ ||
+        static_cast<int64_t>(writer_.bytes()) >= max_bytes_) {
+        return flush();
+    }
+    return true;
+}
+
+bool RedisPipeline::flush() {
+    if (!ctx_ || pending_.empty()) return true;
+
+    // Push the whole batch out before reading anything back. hiredis' own
+    // output buffer is never used here, so its reader stays in sync.
+    auto sent_at = std::chrono::steady_clock::now();
+    const bool written = writer_.write_to(ctx_->fd);
+    retained_.clear();
+    retained_str_.clear();
+    if (!written) {
+        LOG_ERR("[redis-pipeline] Write failed with %zu commands queued", pending_.size());
+        errors_ += static_cast<int64_t>(pending_.size());
+        pending_.clear();
+        return false;
+    }
+
+    while (!pending_.empty()) {
+        void* raw = nullptr;
+        if (redisGetReply(ctx_, &raw) != REDIS_OK || !raw) {
+            LOG_ERR("[redis-pipeline] Connection lost with %zu replies outstanding: %s",
+                pending_.size(), ctx_->errstr);
+            errors_ += static_cast<int64_t>(pending_.size());
+            pending_.clear();
+            return false;
+        }
+        auto* reply = static_cast<redisReply*>(raw);
+        const Pending p = pending_.front();
+        pending_.pop_front();
+
+        // "-MOVED <slot> <host:port>" / "-ASK <slot> <host:port>"
+        const bool moved = reply->type == REDIS_REPLY_ERROR &&
+                           std::strncmp(reply->str, "MOVED ", 6) == 0;
+        const bool ask = reply->type == REDIS_REPLY_ERROR &&
+                         std::strncmp(reply->str, "ASK ", 4) == 0;
+        if (!p.counted) {
+            // control reply (ASKING): nothing to record
+        } else if (moved || ask) {
+            const char* addr = std::strrchr(reply->str, ' ');
+            redirects_.push_back({p.tag, ask, addr ? addr + 1 : ""});
+        } else {
+            if (track_latency_) {
+                result_.per_file_latencies_ns.push_back(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - sent_at).count());
+            }
+            if (reply->type == REDIS_REPLY_ERROR) {
+                // Log the first few only; a misconfigured run would flood the log
+                if (errors_ < 10) LOG_ERR("[redis-pipeline] Command failed: %s", reply->str);
+                ++errors_;
+            } else {
+                result_.rows_affected++;
+                if (reply->type == REDIS_REPLY_INTEGER) {
+                    ++int_count_;
+                    int_sum_ += reply->integer;
+                    int_sum_sq_ += static_cast<double>(reply->integer) *
+                                   static_cast<double>(reply->integer);
+                }
+            }
+        }
+        freeReplyObject(reply);
+    }
+    return true;
+}
+
+#else
+
+bool RedisPipeline::append(int, const char**, const size_t*, size_t) { return false; }
+bool RedisPipeline::append_control(int, const char**, const size_t*) { return false; }
+RespWriter& RedisPipeline::begin_command(int) { return writer_; }
+bool RedisPipeline::end_command(size_t) { writer_.clear(); return false; }
+const char* RedisPipeline::retain(std::vector<char> buf) {
+    retained_.push_back(std::move(buf));
+    return retained_.back().data();
+}
+const char* RedisPipeline::retain(std::string buf) {
+    retained_str_.push_back(std::move(buf));
+    return retained_str_.back().data();
+}
+bool RedisPipeline::queue(Pending) { return false; }
+bool RedisPipeline::flush() { return pending_.empty(); }
+
+#endif
+
+} // namespace dedup
@@ -0,0 +1,108 @@
+#pragma once
+// hiredis pipelining for Redis load stages
+//
+// Commands are encoded by RespWriter (large arguments referenced, not
+// copied) and flushed with writev() on the hiredis socket every `depth`
+// commands or `max_bytes` of encoded data, whichever comes first; the
+// replies of a flushed batch are then read in order with redisGetReply.
+// depth <= 1 = one round trip per command (same behaviour as blocking
+// redisCommand).
+//
+// Arguments of RespWriter::zero_copy_min bytes or more must stay valid until
+// the batch is flushed: keep them alive until finish(), or hand the buffer
+// over with retain().
+//
+// Latency of command i = time from the flush of its batch to the arrival of
+// its own reply, i.e. it includes the replies queued ahead of it.
+//
+// Cluster redirects (-MOVED / -ASK) are neither rows nor errors: they are
+// collected with the caller's tag so the command can be re-routed.
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+#include "db_connector.hpp"
+#include "resp_writer.hpp"
+
+struct redisContext;
+
+namespace dedup {
+
+class RedisPipeline {
+public:
+    struct Redirect {
+        size_t tag;
+        bool ask;          // ASK: retry once on `addr` prefixed with ASKING
+        std::string addr;  // "host:port" of the node that owns the slot
+    };
+
+    // Results (rows_affected, per_file_latencies_ns if track_latency) are
+    // accumulated into `result`
+    RedisPipeline(redisContext* ctx, int depth, int64_t max_bytes,
+                  MeasureResult& result, bool track_latency)
+        : ctx_(ctx), depth_(depth > 1 ? depth : 1),
+          max_bytes_(max_bytes > 0 ? max_bytes : 1), result_(result),
+          track_latency_(track_latency) {}
+
+    ~RedisPipeline() { finish(); }
+
+    RedisPipeline(const RedisPipeline&) = delete;
+    RedisPipeline& operator=(const RedisPipeline&) = delete;
+
+    // Queue one command; flushes and drains the batch once a threshold is
+    // reached. `tag` identifies the command in redirects().
+    bool append(int argc, const char** argv, const size_t* argvlen, size_t tag = 0);
+
+    // Same without an argv array: encode the argc arguments on the returned
+    // writer, then end_command()
+    RespWriter& begin_command(int argc);
+    bool end_command(size_t tag = 0);
+
+    // Keeps `buf` alive until the current batch is flushed; returns its data
+    const char* retain(std::vector<char> buf);
+    const char* retain(std::string buf);
+
+    // Queue a command whose reply is not counted (ASKING)
+    bool append_control(int argc, const char** argv, const size_t* argvlen);
+
+    // Flush the pending batch and read all of its replies
+    bool flush();
+
+    // Same as flush(); called by the destructor
+    void finish() { flush(); }
+
+    [[nodiscard]] int64_t errors() const { return errors_; }
+    [[nodiscard]] int pending() const { return static_cast<int>(pending_.size()); }
+    [[nodiscard]] const std::vector<Redirect>& redirects() const { return redirects_; }
+    // Integer replies of counted commands (UNLINK: keys removed,
+    // MEMORY USAGE: bytes); nil replies are not integers
+    [[nodiscard]] int64_t integer_count() const { return int_count_; }
+    [[nodiscard]] int64_t integer_sum() const { return int_sum_; }
+    [[nodiscard]] double integer_sum_sq() const { return int_sum_sq_; }
+
+private:
+    redisContext* ctx_;
+    int depth_;
+    int64_t max_bytes_;
+    MeasureResult& result_;
+    bool track_latency_;
+    struct Pending {
+        size_t tag;
+        bool counted;
+    };
+    std::deque<Pending> pending_;
+    RespWriter writer_;
+    std::vector<std::vector<char>> retained_;
+    std::deque<std::string> retained_str_;  // deque: SSO data moves with the string
+    int64_t errors_ = 0;
+    std::vector<Redirect> redirects_;
+    int64_t int_count_ = 0;
+    int64_t int_sum_ = 0;
+    double int_sum_sq_ = 0;
+
+    bool queue(Pending p);
+};
+
+} // namespace dedup
@@ -0,0 +1,104 @@
+#include "resp_writer.hpp"
+#include "../utils/logger.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <sys/uio.h>
+
+namespace dedup {
+
+void RespWriter::copy(const char* p, size_t n) {
+    if (n == 0) return;
+    const size_t off = buf_.size();
+    buf_.append(p, n);
+    bytes_ += n;
+    // Extend the trailing buffer segment instead of adding a new iovec
+    if (!segs_.empty() && !segs_.back().ext &&
+        segs_.back().off + segs_.back().len == off) {
+        segs_.back().len += n;
+    } else {
+        segs_.push_back({nullptr, off, n});
+    }
+}
+
+void RespWriter::copy_len(char type, size_t n) {
+    char tmp[24];
+    tmp[0] = type;
+    auto [end, ec] = std::to_chars(tmp + 1, tmp + sizeof(tmp) - 2, n);
+    (void)ec;
+    *end++ = '\r';
+    *end++ = '\n';
+    copy(tmp, static_cast<size_t>(end - tmp));
+}
+
+void RespWriter::command(int argc) {
+    copy_len('*', static_cast<size_t>(argc));
+}
+
+void RespWriter::arg(const char* data, size_t len) {
+    copy_len('$', len);
+    if (len >= zero_copy_min_) {
+        segs_.push_back({data, 0, len});
+        bytes_ += len;
+    } else {
+        copy(data, len);
+    }
+    copy("\r\n", 2);
+}
+
+void RespWriter::arg_int(int64_t v) {
+    char tmp[24];
+    auto [end, ec] = std::to_chars(tmp, tmp + sizeof(tmp), v);
+    (void)ec;
+    arg(tmp, static_cast<size_t>(end - tmp));
+}
+
+void RespWriter::arg_double(double v) {
+    char tmp[400];  // "%f" of DBL_MAX is 316 characters
+    int n = std::snprintf(tmp, sizeof(tmp), "%f", v);
+    arg(tmp, n > 0 ? static_cast<size_t>(n) : 0);
+}
+
+void RespWriter::clear() {
+    buf_.clear();
+    segs_.clear();
+    bytes_ = 0;
+}
+
+bool RespWriter::write_to(int fd) {
+    std::vector<iovec> iov(segs_.size());
+    for (size_t i = 0; i < segs_.size(); ++i) {
+        const auto& s = segs_[i];
+        iov[i].iov_base = const_cast<char*>(s.ext ? s.ext : buf_.data() + s.off);
+        iov[i].iov_len = s.len;
+    }
+
+    size_t first = 0;
+    while (first < iov.size()) {
+        const int cnt = static_cast<int>(std::min<size_t>(iov.size() - first, IOV_MAX));
+        ssize_t n = ::writev(fd, iov.data() + first, cnt);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            LOG_ERR("[resp] writev failed: %s", std::strerror(errno));
+            clear();
+            return false;
+        }
+        // Skip fully written iovecs, trim a partially written one
+        auto left = static_cast<size_t>(n);
+        while (first < iov.size() && left >= iov[first].iov_len) {
+            left -= iov[first].iov_len;
+            ++first;
+        }
+        if (left > 0) {
+            iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + left;
+            iov[first].iov_len -= left;
+        }
+    }
+    clear();
+    return true;
+}
+
+} // namespace dedup
@@ -0,0 +1,58 @@
+#pragma once
+// RESP command encoder with zero-copy payloads
+//
+// Commands are RESP arrays of bulk strings (identical in RESP2 and RESP3;
+// only replies differ). The framing ("*<n>\r\n", "$<len>\r\n", "\r\n") and
+// short arguments are copied into one reusable buffer; arguments of at
+// least `zero_copy_min` bytes are only referenced and go to the socket as
+// their own iovec in writev(), so large values (images, file payloads) are
+// never copied in user space.
+//
+// Referenced arguments must stay valid until write_to() has returned.
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dedup {
+
+class RespWriter {
+public:
+    explicit RespWriter(size_t zero_copy_min = 1024)
+        : zero_copy_min_(zero_copy_min < 64 ? 64 : zero_copy_min) {}
+
+    // Array header for a command of argc arguments
+    void command(int argc);
+
+    // One bulk-string argument (copied below zero_copy_min, else referenced)
+    void arg(const char* data, size_t len);
+    void arg(std::string_view s) { arg(s.data(), s.size()); }
+    void arg_int(int64_t v);
+    void arg_double(double v);  // "%f", same text as std::to_string
+
+    // writev() everything queued (partial writes and EINTR handled), then
+    // clear(). false on socket error; the queue is cleared either way.
+    bool write_to(int fd);
+
+    void clear();
+    [[nodiscard]] bool empty() const { return segs_.empty(); }
+    [[nodiscard]] size_t bytes() const { return bytes_; }
+
+private:
+    // ext == nullptr: [off, off+len) of buf_ (offsets survive reallocation)
+    struct Segment {
+        const char* ext;
+        size_t off;
+        size_t len;
+    };
+    std::string buf_;
+    std::vector<Segment> segs_;
+    size_t zero_copy_min_;
+    size_t bytes_ = 0;
+
+    void copy(const char* p, size_t n);
+    void copy_len(char type, size_t n);  // "<type><n>\r\n"
+};
+
+} // namespace dedup
@@ -0,0 +1,424 @@
+#include "s3_uploader.hpp"
+#include "../utils/logger.hpp"
+#include "../utils/sha256.hpp"
+#include <curl/curl.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <fcntl.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace dedup {
+
+namespace {
+constexpr size_t HASH_CHUNK = 1 << 20;
+
+// S3 multipart limits: parts of at least 5 MiB (except the last), at most
+// 10000 parts per object
+constexpr int64_t MIN_PART_SIZE = 5LL * 1024 * 1024;
+constexpr int64_t MAX_PARTS = 10000;
+constexpr int MAX_PART_ATTEMPTS = 3;
+
+// Text of the first <tag>...</tag> in an S3 XML response
+std::string xml_value(const std::string& xml, const std::string& tag) {
+    const std::string open = "<" + tag + ">";
+    size_t pos = xml.find(open);
+    if (pos == std::string::npos) return "";
+    pos += open.size();
+    size_t end = xml.find("</" + tag + ">", pos);
+    return end == std::string::npos ? "" : xml.substr(pos, end - pos);
+}
+} // namespace
+
+std::string s3_uri_encode(const std::string& s) {
+    static const char* const HEX = "0123456789ABCDEF";
+    std::string out;
+    for (unsigned char c : s) {
+        if (std::isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~') {
+            out += static_cast<char>(c);
+        } else {
+            out += '%';
+            out += HEX[c >> 4];
+            out += HEX[c & 0xF];
+        }
+    }
+    return out;
+}
+
+S3Uploader::S3Uploader(std::string endpoint, Signer sign, const Options& opts,
+                       MeasureResult& result)
+    : endpoint_(std::move(endpoint)), sign_(std::move(sign)), opts_(opts), result_(result) {
+    if (opts_.max_inflight < 1) opts_.max_inflight = 1;
+    multi_ = curl_multi_init();
+    // One connection per in-flight PUT (plain HTTP/1.1, no multiplexing),
+    // all kept open for the next objects
+    curl_multi_setopt(multi_, CURLMOPT_MAX_HOST_CONNECTIONS, static_cast<long>(opts_.max_inflight));
+    curl_multi_setopt(multi_, CURLMOPT_MAXCONNECTS, static_cast<long>(opts_.max_inflight));
+}
+
+S3Uploader::~S3Uploader() {
+    finish();
+    if (multi_) curl_multi_cleanup(multi_);
+}
+
+bool S3Uploader::add(const std::string& path, const std::string& file) {
+    objects_.emplace_back();
+    Object& obj = objects_.back();
+    obj.path = path;
+
+    obj.fd = ::open(file.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat st{};
+    if (obj.fd < 0 || ::fstat(obj.fd, &st) != 0) {
+        obj.error = "cannot read " + file;
+        if (obj.fd >= 0) ::close(obj.fd);
+        obj.fd = -1;
+        return false;
+    }
+    obj.size = st.st_size;
+    ::posix_fadvise(obj.fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    if (opts_.multipart_threshold <= 0 || obj.size < opts_.multipart_threshold) {
+        if (!opts_.unsigned_payload && !hash_file(obj, 0, nullptr)) {
+            obj.error = "read error on " + file;
+            ::close(obj.fd);
+            obj.fd = -1;
+            return false;
+        }
+        obj.parts_left = 1;
+        submit(obj, 0, 0, obj.size,
+               opts_.unsigned_payload ? S3_UNSIGNED_PAYLOAD : obj.fingerprint);
+        return true;
+    }
+
+    int64_t part_size = std::max(opts_.part_size, MIN_PART_SIZE);
+    if ((obj.size + part_size - 1) / part_size > MAX_PARTS) {
+        // Smallest whole-MiB part size that fits the object into MAX_PARTS
+        const int64_t mib = 1024 * 1024;
+        part_size = ((obj.size + MAX_PARTS - 1) / MAX_PARTS + mib - 1) / mib * mib;
+        LOG_WRN("[minio] %s: %lld bytes need %lld MiB parts", path.c_str(),
+            static_cast<long long>(obj.size), static_cast<long long>(part_size / mib));
+    }
+    const int parts = static_cast<int>((obj.size + part_size - 1) / part_size);
+
+    // Fingerprint and part hashes first: the fingerprint is object metadata,
+    // which only CreateMultipartUpload can set
+    std::vector<std::string> part_hashes;
+    if (!opts_.unsigned_payload && !hash_file(obj, part_size, &part_hashes)) {
+        obj.error = "read error on " + file;
+        ::close(obj.fd);
+        obj.fd = -1;
+        return false;
+    }
+
+    obj.start = std::chrono::steady_clock::now();
+    if (!create_multipart(obj)) {
+        ::close(obj.fd);
+        obj.fd = -1;
+        return false;
+    }
+    ++multipart_objects_;
+    obj.etags.resize(parts);
+    obj.parts_left = parts;
+
+    for (int n = 1; n <= parts; ++n) {
+        const int64_t begin = (n - 1) * part_size;
+        const int64_t len = std::min(part_size, obj.size - begin);
+        submit(obj, n, begin, len,
+               opts_.unsigned_payload ? S3_UNSIGNED_PAYLOAD : part_hashes[n - 1]);
+    }
+    return true;
+}
+
+bool S3Uploader::hash_file(Object& obj, int64_t part_size, std::vector<std::string>* part_hashes) {
+    // Running transfers are kept moving meanwhile
+    hash_buf_.resize(HASH_CHUNK);
+    SHA256 whole;
+    SHA256 part;
+    int64_t part_end = part_hashes ? std::min(part_size, obj.size) : obj.size;
+    for (int64_t off = 0; off < obj.size;) {
+        // Chunks never straddle a part boundary
+        size_t want = static_cast<size_t>(std::min<int64_t>(HASH_CHUNK, part_end - off));
+        ssize_t n = ::pread(obj.fd, hash_buf_.data(), want, off);
+        if (n <= 0) return false;
+        whole.update(hash_buf_.data(), static_cast<size_t>(n));
+        off += n;
+        if (part_hashes) {
+            part.update(hash_buf_.data(), static_cast<size_t>(n));
+            if (off == part_end) {
+                part_hashes->push_back(SHA256::to_hex(part.finalize()));
+                part.reset();
+                part_end = std::min(part_end + part_size, obj.size);
+            }
+        }
+        if (!active_.empty()) pump(0);
+    }
+    obj.fingerprint = SHA256::to_hex(whole.finalize());
+    return true;
+}
+
+void S3Uploader::submit(Object& obj, int part, int64_t begin, int64_t len,
+                        const std::string& payload_hash) {
+    while (static_cast<int>(active_.size()) >= opts_.max_inflight) pump(100);
+
+    std::string path = obj.path;
+    if (part > 0) {
+        path += "?partNumber=" + std::to_string(part) + "&uploadId=" + s3_uri_encode(obj.upload_id);
+    }
+
+    active_.emplace_back();
+    Transfer& t = active_.back();
+    t.obj = &obj;
+    t.part = part;
+    t.begin = begin;
+    t.len = len;
+    t.url = endpoint_ + path;
+    // The fingerprint is metadata of the object, not of its parts
+    t.headers = sign_("PUT", path, payload_hash, part == 0 ? obj.fingerprint : "");
+    t.headers.add("Content-Type: application/octet-stream");
+    t.headers.add("Expect:");
+
+    if (part == 0) obj.start = std::chrono::steady_clock::now();
+    launch(t);
+    pump(0);
+}
+
+void S3Uploader::launch(Transfer& t) {
+    t.offset = 0;
+    t.etag.clear();
+    t.handle.emplace(HttpClient::acquire());
+    CURL* curl = t.handle->get();
+    HttpRequest req;
+    req.url = t.url;
+    req.headers = &t.headers;
+    if (t.kind != Transfer::Kind::PUT) {
+        req.method = t.kind == Transfer::Kind::COMPLETE ? "POST" : "DELETE";
+        if (!t.body.empty()) {
+            req.body = t.body.data();
+            req.body_len = t.body.size();
+        }
+        req.timeout_s = 60;
+        HttpClient::prepare(curl, req, t.resp);
+        curl_easy_setopt(curl, CURLOPT_PRIVATE, &t);
+        curl_multi_add_handle(multi_, curl);
+        return;
+    }
+    req.method = "PUT";
+    req.timeout_s = 300;  // shares the link with max_inflight - 1 others
+    HttpClient::prepare(curl, req, t.resp);
+    // Body streamed from the descriptor
+    curl_easy_setopt(curl, CURLOPT_UPLOAD, 1L);
+    curl_easy_setopt(curl, CURLOPT_READFUNCTION, read_body);
+    curl_easy_setopt(curl, CURLOPT_READDATA, &t);
+    curl_easy_setopt(curl, CURLOPT_SEEKFUNCTION, seek_body);  // resend on a stale connection
+    curl_easy_setopt(curl, CURLOPT_SEEKDATA, &t);
+    curl_easy_setopt(curl, CURLOPT_INFILESIZE_LARGE, static_cast<curl_off_t>(t.len));
+    if (t.part > 0) {
+        curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, read_header);
+        curl_easy_setopt(curl, CURLOPT_HEADERDATA, &t);
+    }
+    curl_easy_setopt(curl, CURLOPT_PRIVATE, &t);
+    curl_multi_add_handle(multi_, curl);
+}
+
+size_t S3Uploader::read_body(char* buf, size_t size, size_t nitems, void* self) {
+    auto* t = static_cast<Transfer*>(self);
+    size_t want = static_cast<size_t>(
+        std::min<int64_t>(static_cast<int64_t>(size * nitems), t->len - t->offset));
+    if (want == 0) return 0;
+    ssize_t n = ::pread(t->obj->fd, buf, want, t->begin + t->offset);
+    if (n < 0) return CURL_READFUNC_ABORT;
+    t->offset += n;
+    return static_cast<size_t>(n);
+}
+
+int S3Uploader::seek_body(void* self, int64_t offset, int origin) {
+    if (origin != SEEK_SET) return CURL_SEEKFUNC_CANTSEEK;
+    static_cast<Transfer*>(self)->offset = offset;
+    return CURL_SEEKFUNC_OK;
+}
+
+size_t S3Uploader::read_header(char* buf, size_t size, size_t nitems, void* self) {
+    const size_t n = size * nitems;
+    if (n > 5 && ::strncasecmp(buf, "ETag:", 5) == 0) {
+        std::string v(buf + 5, n - 5);
+        v.erase(0, v.find_first_not_of(" \t"));
+        v.erase(v.find_last_not_of(" \t\r\n") + 1);
+        static_cast<Transfer*>(self)->etag = v;
+    }
+    return n;
+}
+
+HttpHeaders S3Uploader::control_headers(const std::string& method, const std::string& path,
+                                        const std::string& body, const std::string& fingerprint) {
+    HttpHeaders headers = sign_(method, path,
+        body.empty() ? S3_EMPTY_SHA256 : SHA256::hash_hex(body.data(), body.size()), fingerprint);
+    if (!body.empty()) {
+        headers.add("Content-Type: application/xml");
+        headers.add("Expect:");
+    }
+    return headers;
+}
+
+HttpResponse S3Uploader::control(const std::string& method, const std::string& path,
+                                 const std::string& body, const std::string& fingerprint) {
+    HttpHeaders headers = control_headers(method, path, body, fingerprint);
+    HttpRequest req;
+    req.method = method;
+    req.url = endpoint_ + path;
+    req.headers = &headers;
+    if (!body.empty()) {
+        req.body = body.data();
+        req.body_len = body.size();
+    }
+    req.timeout_s = 60;
+    return HttpClient::perform(req);
+}
+
+bool S3Uploader::create_multipart(Object& obj) {
+    auto resp = control("POST", obj.path + "?uploads", "", obj.fingerprint);
+    if (resp.ok()) obj.upload_id = xml_value(resp.body, "UploadId");
+    if (obj.upload_id.empty()) {
+        obj.error = "CreateMultipartUpload: " + resp.error();
+        return false;
+    }
+    return true;
+}
+
+void S3Uploader::submit_control(Object& obj, Transfer::Kind kind) {
+    const std::string path = obj.path + "?uploadId=" + s3_uri_encode(obj.upload_id);
+
+    active_.emplace_back();
+    Transfer& t = active_.back();
+    t.kind = kind;
+    t.obj = &obj;
+    t.url = endpoint_ + path;
+    if (kind == Transfer::Kind::COMPLETE) {
+        t.body = "<CompleteMultipartUpload>";
+        for (size_t i = 0; i < obj.etags.size(); ++i) {
+            t.body += "<Part><PartNumber>" + std::to_string(i + 1) + "</PartNumber><ETag>" +
+                      obj.etags[i] + "</ETag></Part>";
+        }
+        t.body += "</CompleteMultipartUpload>";
+    }
+    t.headers = control_headers(kind == Transfer::Kind::COMPLETE ? "POST" : "DELETE",
+                                path, t.body, "");
+    launch(t);
+}
+
+void S3Uploader::complete_object(Object& obj) {
+    if (obj.upload_id.empty()) {
+        record_outcome(obj);
+    } else {
+        // A failed object is aborted: MinIO keeps uploaded parts until then
+        submit_control(obj, obj.error.empty() ? Transfer::Kind::COMPLETE : Transfer::Kind::ABORT);
+    }
+}
+
+void S3Uploader::record_outcome(Object& obj) {
+    obj.latency_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - obj.start).count();
+    obj.ok = obj.error.empty();
+    ::close(obj.fd);
+    obj.fd = -1;
+}
+
+void S3Uploader::pump(int timeout_ms) {
+    int running = 0;
+    curl_multi_perform(multi_, &running);
+    if (timeout_ms > 0 && running > 0) {
+        curl_multi_poll(multi_, nullptr, 0, timeout_ms, nullptr);
+        curl_multi_perform(multi_, &running);
+    }
+    reap();
+}
+
+void S3Uploader::reap() {
+    int queued = 0;
+    while (CURLMsg* msg = curl_multi_info_read(multi_, &queued)) {
+        if (msg->msg != CURLMSG_DONE) continue;
+        CURL* curl = msg->easy_handle;
+        const int code = msg->data.result;
+        Transfer* t = nullptr;
+        curl_easy_getinfo(curl, CURLINFO_PRIVATE, reinterpret_cast<char**>(&t));
+
+        HttpClient::complete(curl, code, t->resp);
+        curl_multi_remove_handle(multi_, curl);
+        t->handle.reset();  // back to the pool
+
+        if (t->kind != Transfer::Kind::PUT) {
+            Object& obj = *t->obj;
+            const Transfer::Kind kind = t->kind;
+            if (kind == Transfer::Kind::COMPLETE) {
+                // S3 may answer 200 and report the failure in the body
+                std::string s3_code = xml_value(t->resp.body, "Code");
+                if (!t->resp.ok() || !s3_code.empty()) {
+                    obj.error = "CompleteMultipartUpload: " +
+                                (s3_code.empty() ? t->resp.error() : s3_code);
+                }
+            } else if (!t->resp.ok()) {
+                LOG_WRN("[minio] AbortMultipartUpload of %s failed: %s",
+                    obj.path.c_str(), t->resp.error().c_str());
+            }
+            active_.remove_if([t](const Transfer& x) { return &x == t; });
+            if (kind == Transfer::Kind::COMPLETE && !obj.error.empty()) {
+                submit_control(obj, Transfer::Kind::ABORT);
+            } else {
+                record_outcome(obj);
+            }
+            continue;
+        }
+
+        if (!t->resp.timing.reused) ++new_connections_;
+        const bool ok = t->resp.curl_code == CURLE_OK && t->resp.status == 200;
+        if (!ok && t->part > 0 && ++t->attempts < MAX_PART_ATTEMPTS) {
+            // Only this part is sent again, not the whole object
+            LOG_WRN("[minio] Part %d of %s failed (%s), resending", t->part,
+                t->obj->path.c_str(), t->resp.error().c_str());
+            launch(*t);
+            continue;
+        }
+
+        Object& obj = *t->obj;
+        if (ok && t->part > 0) {
+            obj.etags[t->part - 1] = t->etag;
+            ++parts_uploaded_;
+        }
+        if (!ok && obj.error.empty()) {
+            obj.error = (t->part > 0 ? "part " + std::to_string(t->part) + ": " : "") +
+                        t->resp.error();
+        }
+        active_.remove_if([t](const Transfer& x) { return &x == t; });
+        if (--obj.parts_left == 0) complete_object(obj);
+    }
+}
+
+void S3Uploader::finish() {
+    if (finished_) return;
+    finished_ = true;
+    while (!active_.empty()) pump(100);
+
+    int64_t failed = 0;
+    for (auto& obj : objects_) {
+        if (obj.fd >= 0) ::close(obj.fd);
+        result_.bytes_logical += obj.size;
+        if (!obj.ok) {
+            // Log the first few only; an outage would flood the log
+            if (failed < 10) {
+                LOG_ERR("[minio] PUT %s failed: %s", obj.path.c_str(), obj.error.c_str());
+            }
+            ++failed;
+            continue;
+        }
+        result_.rows_affected++;
+        if (opts_.track_latency) result_.per_file_latencies_ns.push_back(obj.latency_ns);
+    }
+    if (failed > 0 && result_.error.empty()) {
+        result_.error = std::to_string(failed) + " of " + std::to_string(objects_.size()) +
+                        " objects not uploaded";
+    }
+    objects_.clear();
+}
+
+} // namespace dedup
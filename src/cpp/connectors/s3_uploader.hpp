@@ -0,0 +1,173 @@
+#pragma once
+// Concurrent S3 PUTs of dataset files on one curl_multi
+//
+// add() queues a file as one object. Its SHA-256 is computed once, reading
+// the file in chunks, and serves both as the dedup fingerprint (stored as
+// x-amz-meta-sha256, like the sha256 column of the SQL connectors) and as
+// the SigV4 x-amz-content-sha256 value. libcurl then reads the body straight
+// from the file descriptor (pread in the read callback) -- no file is ever
+// held in memory as a whole. With unsigned_payload nothing is hashed: the
+// body is sent as UNSIGNED-PAYLOAD and no fingerprint is stored. At most
+// max_inflight PUTs run at a time, each on its own keep-alive connection;
+// add() drives the transfers while the window is full.
+//
+// Files of at least multipart_threshold bytes go up as S3 multipart uploads:
+// CreateMultipartUpload (carrying the fingerprint), one UploadPart per
+// part_size slice (sharing the window with all other PUTs, so the parts of
+// one object run in parallel), then CompleteMultipartUpload. The same
+// hashing pass yields the fingerprint and every part's payload hash. A
+// failed part is resent up to twice; an object that still fails is aborted
+// (AbortMultipartUpload) so no orphaned parts stay on the server. Complete
+// and Abort go on the same curl_multi as the PUTs, so finishing one object
+// never stalls the transfers of the others.
+//
+// Latency of object i = submission to completion of its PUT (with
+// max_inflight 1 that is exactly the blocking request time); for multipart
+// objects from CreateMultipartUpload to CompleteMultipartUpload.
+//
+// finish() drains the window and folds the outcomes into the MeasureResult
+// in add() order, so results never depend on completion order. Objects are
+// named by the caller, so which keys get written is fixed by the add() calls.
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
+#include <optional>
+#include <string>
+#include <vector>
+#include "db_connector.hpp"
+#include "http_client.hpp"
+
+typedef void CURLM;
+
+namespace dedup {
+
+// x-amz-content-sha256 of an empty body / of a body sent without hash
+inline constexpr const char* S3_EMPTY_SHA256 =
+    "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855";
+inline constexpr const char* S3_UNSIGNED_PAYLOAD = "UNSIGNED-PAYLOAD";
+
+// URI-encode a query value (SigV4: unreserved characters kept, rest %XX)
+std::string s3_uri_encode(const std::string& s);
+
+class S3Uploader {
+public:
+    // Signed request headers for `method` on `path` ("/bucket/key", query
+    // string included) with the given payload hash; a non-empty fingerprint
+    // goes into x-amz-meta-sha256
+    using Signer = std::function<HttpHeaders(const std::string& method, const std::string& path,
+                                             const std::string& payload_hash,
+                                             const std::string& fingerprint)>;
+
+    struct Options {
+        int max_inflight = 1;
+        bool track_latency = false;     // per_file_latencies_ns
+        int64_t multipart_threshold = 0;  // bytes; 0 = always a single PUT
+        int64_t part_size = 16LL * 1024 * 1024;
+        bool unsigned_payload = false;  // UNSIGNED-PAYLOAD, no hashing
+    };
+
+    // Uploaded objects go to result.rows_affected, file sizes to
+    // bytes_logical, latencies to per_file_latencies_ns if track_latency
+    S3Uploader(std::string endpoint, Signer sign, const Options& opts, MeasureResult& result);
+    ~S3Uploader();
+
+    S3Uploader(const S3Uploader&) = delete;
+    S3Uploader& operator=(const S3Uploader&) = delete;
+
+    // Queue `file` as object `path`; false if the file cannot be read or the
+    // multipart upload cannot be created (the object then counts as failed)
+    bool add(const std::string& path, const std::string& file);
+
+    // Wait for all transfers and fold the results in; called by the destructor
+    void finish();
+
+    // PUTs that had to open a new connection (latency includes TCP setup)
+    [[nodiscard]] int64_t new_connections() const { return new_connections_; }
+    // Objects sent as multipart uploads and their parts
+    [[nodiscard]] int64_t multipart_objects() const { return multipart_objects_; }
+    [[nodiscard]] int64_t parts_uploaded() const { return parts_uploaded_; }
+
+private:
+    struct Object {
+        std::string path;
+        int fd = -1;
+        int64_t size = 0;
+        std::string fingerprint;         // SHA-256 hex, "" with unsigned_payload
+        std::string upload_id;           // multipart only
+        std::vector<std::string> etags;  // per part, for CompleteMultipartUpload
+        int parts_left = 0;              // transfers not yet finished
+        std::chrono::steady_clock::time_point start;
+        int64_t latency_ns = -1;
+        bool ok = false;
+        std::string error;
+    };
+
+    // One request in flight: the PUT of a whole object (part 0) or of one
+    // part, or the Complete / Abort of a multipart upload
+    struct Transfer {
+        enum class Kind { PUT, COMPLETE, ABORT };
+        Kind kind = Kind::PUT;
+        Object* obj = nullptr;
+        int part = 0;
+        int attempts = 0;
+        int64_t begin = 0;
+        int64_t len = 0;
+        int64_t offset = 0;  // read position within [begin, begin + len)
+        std::string url;
+        std::string body;  // COMPLETE: the part list XML (sent from here)
+        HttpHeaders headers;
+        HttpResponse resp;
+        std::string etag;
+        std::optional<HttpClient::Handle> handle;
+    };
+
+    std::string endpoint_;
+    Signer sign_;
+    Options opts_;
+    MeasureResult& result_;
+    CURLM* multi_ = nullptr;
+    std::deque<Object> objects_;   // deque: Transfer::obj pointers stay valid
+    std::list<Transfer> active_;   // list: PRIVATE pointers stay valid
+    int64_t new_connections_ = 0;
+    int64_t multipart_objects_ = 0;
+    int64_t parts_uploaded_ = 0;
+    std::vector<char> hash_buf_;
+    bool finished_ = false;
+
+    // One read of obj.fd: obj.fingerprint and, if part_hashes is given, the
+    // SHA-256 hex of every part_size slice; false on a read error
+    bool hash_file(Object& obj, int64_t part_size, std::vector<std::string>* part_hashes);
+    // Sign and submit one PUT once a window slot is free
+    void submit(Object& obj, int part, int64_t begin, int64_t len,
+                const std::string& payload_hash);
+    void launch(Transfer& t);
+
+    // Signed headers of a multipart control request with an in-memory body
+    HttpHeaders control_headers(const std::string& method, const std::string& path,
+                                const std::string& body, const std::string& fingerprint);
+    // Blocking control request (CreateMultipartUpload, issued from add())
+    HttpResponse control(const std::string& method, const std::string& path,
+                         const std::string& body, const std::string& fingerprint = "");
+    bool create_multipart(Object& obj);
+    // Queue CompleteMultipartUpload / AbortMultipartUpload of `obj` on the
+    // multi handle; does not wait for a window slot
+    void submit_control(Object& obj, Transfer::Kind kind);
+    // All part transfers of `obj` are done: complete (or abort) a multipart
+    // upload, else record the outcome right away
+    void complete_object(Object& obj);
+    // Latency, status and file descriptor of a finished object
+    void record_outcome(Object& obj);
+
+    // curl_multi_perform, then wait up to timeout_ms for socket activity
+    // and complete finished transfers
+    void pump(int timeout_ms);
+    void reap();
+
+    static size_t read_body(char* buf, size_t size, size_t nitems, void* self);
+    static int seek_body(void* self, int64_t offset, int origin);
+    static size_t read_header(char* buf, size_t size, size_t nitems, void* self);
+};
+
+} // namespace dedup
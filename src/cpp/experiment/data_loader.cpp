@@ -32,7 +32,8 @@ nlohmann::json ExperimentResult::to_json() const {
         {"volume_name", volume_name},
         {"timestamp", timestamp},
         {"error", error},
-        {"insertion_mode", insertion_mode}
+        {"insertion_mode", insertion_mode},
+        {"variant", variant}
     };
 
     // DB-internal instrumentation (doku.tex §6.5)
@@ -40,6 +41,8 @@ nlohmann::json ExperimentResult::to_json() const {
         j["db_internal_before"] = db_internal_before;
     if (!db_internal_after.is_null() && !db_internal_after.empty())
         j["db_internal_after"] = db_internal_after;
+    if (!db_internal_delta.is_null() && !db_internal_delta.empty())
+        j["db_internal_delta"] = db_internal_delta;
 
     // Per-file latency stats (populated for perfile_insert / perfile_delete stages)
     if (latency_count > 0) {
@@ -60,6 +63,28 @@ nlohmann::json ExperimentResult::to_json() const {
         };
     }
 
+    if (enqueue_latency_count > 0) {
+        j["enqueue_latency"] = {
+            {"count", enqueue_latency_count},
+            {"p50_ns", enqueue_latency_p50_ns},
+            {"p99_ns", enqueue_latency_p99_ns},
+            {"mean_ns", enqueue_latency_mean_ns}
+        };
+    }
+
+    if (txn_retries > 0) {
+        j["txn_retries"] = txn_retries;
+    }
+
+    if (!worker_durations_ns.empty()) {
+        j["parallelism"] = worker_durations_ns.size();
+        j["worker_durations_ns"] = worker_durations_ns;
+    }
+
+    if (!partition_durations_ns.empty()) {
+        j["partition_durations_ns"] = partition_durations_ns;
+    }
+
     return j;
 }
 
@@ -93,6 +118,7 @@ ExperimentResult DataLoader::run_stage(
     result.stage = stage_str(stage);
     result.replica_count = replica_count_;
     result.timestamp = current_timestamp();
+    result.variant = connector.current_variant();
 
     LOG_INF("=== %s / %s / %s / %s ===", result.system.c_str(),
         result.payload_type.c_str(), result.dup_grade.c_str(), result.stage.c_str());
@@ -177,6 +203,9 @@ ExperimentResult DataLoader::run_stage(
     result.rows_affected = mr.rows_affected;
     result.bytes_logical = mr.bytes_logical;
     result.error = mr.error;
+    result.worker_durations_ns = mr.worker_durations_ns;
+    result.partition_durations_ns = mr.partition_durations_ns;
+    result.txn_retries = mr.txn_retries;
 
     // Compute per-file latency statistics (percentiles, min, max, mean)
     if (!mr.per_file_latencies_ns.empty()) {
@@ -200,6 +229,16 @@ ExperimentResult DataLoader::run_stage(
             result.latency_p99_ns / 1000, result.latency_min_ns / 1000, result.latency_max_ns / 1000);
     }
 
+    if (!mr.enqueue_latencies_ns.empty()) {
+        auto& enq = mr.enqueue_latencies_ns;
+        std::sort(enq.begin(), enq.end());
+        result.enqueue_latency_count = static_cast<int64_t>(enq.size());
+        result.enqueue_latency_p50_ns = enq[static_cast<size_t>(0.50 * static_cast<double>(enq.size() - 1))];
+        result.enqueue_latency_p99_ns = enq[static_cast<size_t>(0.99 * static_cast<double>(enq.size() - 1))];
+        result.enqueue_latency_mean_ns = static_cast<double>(
+            std::accumulate(enq.begin(), enq.end(), int64_t{0})) / static_cast<double>(enq.size());
+    }
+
     // Compute ingest throughput (doku.tex 5.4.1: bytes/s)
     if (result.duration_ns > 0 && result.bytes_logical > 0) {
         double seconds = static_cast<double>(result.duration_ns) / 1e9;
@@ -235,6 +274,8 @@ ExperimentResult DataLoader::run_stage(
     // ---- DB-internal snapshot AFTER (doku.tex §6.5) ----
     if (db_internal_metrics_) {
         result.db_internal_after = db_internal::snapshot(db_conn);
+        result.db_internal_delta = db_internal::delta(result.db_internal_before,
+                                                      result.db_internal_after);
         LOG_INF("DB-internal snapshot AFTER captured (%zu fields)",
             result.db_internal_after.value("data", nlohmann::json::object()).size());
     }
@@ -327,8 +368,10 @@ std::vector<ExperimentResult> DataLoader::run_full_experiment(
         j_results.push_back(r.to_json());
     }
 
+    const std::string variant = connector.current_variant();
     std::string outpath = "results/" + std::string(connector.system_name()) +
-        "_" + payload_type_str(payload_type) + "_results.json";
+        "_" + payload_type_str(payload_type) +
+        (variant.empty() ? "" : "_" + variant) + "_results.json";
     std::ofstream out(outpath);
     if (out.is_open()) {
         out << j_results.dump(2);
@@ -359,6 +402,7 @@ ExperimentResult DataLoader::run_native_stage(
     result.stage = stage_str(stage);
     result.replica_count = replica_count_;
     result.timestamp = current_timestamp();
+    result.variant = connector.current_variant();
     result.insertion_mode = "native";
 
     LOG_INF("=== NATIVE %s / %s / %s / %s (%zu records) ===",
@@ -416,6 +460,9 @@ ExperimentResult DataLoader::run_native_stage(
     result.rows_affected = mr.rows_affected;
     result.bytes_logical = mr.bytes_logical;
     result.error = mr.error;
+    result.worker_durations_ns = mr.worker_durations_ns;
+    result.partition_durations_ns = mr.partition_durations_ns;
+    result.txn_retries = mr.txn_retries;
 
     // Latency statistics
     if (!mr.per_file_latencies_ns.empty()) {
@@ -435,6 +482,16 @@ ExperimentResult DataLoader::run_native_stage(
         result.latency_p99_ns = pctl(0.99);
     }
 
+    if (!mr.enqueue_latencies_ns.empty()) {
+        auto& enq = mr.enqueue_latencies_ns;
+        std::sort(enq.begin(), enq.end());
+        result.enqueue_latency_count = static_cast<int64_t>(enq.size());
+        result.enqueue_latency_p50_ns = enq[static_cast<size_t>(0.50 * static_cast<double>(enq.size() - 1))];
+        result.enqueue_latency_p99_ns = enq[static_cast<size_t>(0.99 * static_cast<double>(enq.size() - 1))];
+        result.enqueue_latency_mean_ns = static_cast<double>(
+            std::accumulate(enq.begin(), enq.end(), int64_t{0})) / static_cast<double>(enq.size());
+    }
+
     // Throughput
     if (result.duration_ns > 0 && result.bytes_logical > 0) {
         double seconds = static_cast<double>(result.duration_ns) / 1e9;
@@ -463,6 +520,8 @@ ExperimentResult DataLoader::run_native_stage(
     // DB-internal snapshot AFTER
     if (db_internal_metrics_) {
         result.db_internal_after = db_internal::snapshot(db_conn);
+        result.db_internal_delta = db_internal::delta(result.db_internal_before,
+                                                      result.db_internal_after);
     }
 
     // Calculate EDR
@@ -558,8 +617,10 @@ std::vector<ExperimentResult> DataLoader::run_native_experiment(
         j_results.push_back(r.to_json());
     }
 
+    const std::string variant = connector.current_variant();
     std::string outpath = "results/native_" + std::string(connector.system_name()) +
-        "_" + payload_type_str(payload_type) + "_results.json";
+        "_" + payload_type_str(payload_type) +
+        (variant.empty() ? "" : "_" + variant) + "_results.json";
     std::ofstream out(outpath);
     if (out.is_open()) {
         out << j_results.dump(2);
@@ -34,11 +34,13 @@ struct ExperimentResult {
     std::string timestamp;
     std::string error;
     std::string insertion_mode = "blob";  // "blob" or "native"
+    std::string variant;                  // connector variant (schema/representation), "" = default
 
     // DB-internal instrumentation snapshots (doku.tex §6.5)
     // Captured at stage boundaries when db_internal_metrics is enabled.
     nlohmann::json db_internal_before;
     nlohmann::json db_internal_after;
+    nlohmann::json db_internal_delta;  // numeric after - before (db_internal::delta)
 
     // Per-file latency stats from perfile_insert / perfile_delete (doku.tex Stage 2/3)
     int64_t latency_count = 0;
@@ -49,6 +51,21 @@ struct ExperimentResult {
     int64_t latency_p99_ns = 0;
     double  latency_mean_ns = 0.0;
 
+    // Enqueue share of the per-file latency (Kafka latency_breakdown)
+    int64_t enqueue_latency_count = 0;
+    int64_t enqueue_latency_p50_ns = 0;
+    int64_t enqueue_latency_p99_ns = 0;
+    double  enqueue_latency_mean_ns = 0.0;
+
+    // Per-worker wall times when the stage ran over several connections
+    std::vector<int64_t> worker_durations_ns;
+
+    // Per-partition maintenance times (hash-partitioned PostgreSQL tables)
+    std::vector<int64_t> partition_durations_ns;
+
+    // Transaction retries the connector performed (CockroachDB 40001)
+    int64_t txn_retries = 0;
+
     nlohmann::json to_json() const;
 };
 
@@ -8,12 +8,15 @@
 // =============================================================================
 
 #include "db_internal_metrics.hpp"
+#include "../connectors/http_client.hpp"
+#include "../connectors/kafka_log_dirs.hpp"
+#include "../connectors/redis_cluster.hpp"
 #include "../utils/logger.hpp"
 
 #include <chrono>
+#include <cstdlib>
 #include <sstream>
 #include <libpq-fe.h>
-#include <curl/curl.h>
 
 #ifdef HAS_HIREDIS
 #include <hiredis/hiredis.h>
@@ -26,41 +29,17 @@
 namespace dedup {
 namespace db_internal {
 
-// --- curl helpers (lightweight duplicates from metrics_trace.cpp) ------------
-
-static size_t curl_cb(char* ptr, size_t sz, size_t n, std::string* d) {
-    d->append(ptr, sz * n);
-    return sz * n;
-}
+// --- HTTP helpers (lightweight duplicates from metrics_trace.cpp) ------------
 
 static std::string http_get(const std::string& url, long timeout_s = 5) {
-    CURL* c = curl_easy_init();
-    if (!c) return "";
-    std::string resp;
-    curl_easy_setopt(c, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(c, CURLOPT_WRITEFUNCTION, curl_cb);
-    curl_easy_setopt(c, CURLOPT_WRITEDATA, &resp);
-    curl_easy_setopt(c, CURLOPT_TIMEOUT, timeout_s);
-    curl_easy_setopt(c, CURLOPT_CONNECTTIMEOUT, 3L);
-    CURLcode rc = curl_easy_perform(c);
-    curl_easy_cleanup(c);
-    return (rc == CURLE_OK) ? resp : "";
+    auto resp = HttpClient::get(url, timeout_s, 3);
+    return (resp.curl_code == 0) ? resp.body : "";
 }
 
 static std::string http_post(const std::string& url, const std::string& body,
                               long timeout_s = 5) {
-    CURL* c = curl_easy_init();
-    if (!c) return "";
-    std::string resp;
-    curl_easy_setopt(c, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(c, CURLOPT_POSTFIELDS, body.c_str());
-    curl_easy_setopt(c, CURLOPT_WRITEFUNCTION, curl_cb);
-    curl_easy_setopt(c, CURLOPT_WRITEDATA, &resp);
-    curl_easy_setopt(c, CURLOPT_TIMEOUT, timeout_s);
-    curl_easy_setopt(c, CURLOPT_CONNECTTIMEOUT, 3L);
-    CURLcode rc = curl_easy_perform(c);
-    curl_easy_cleanup(c);
-    return (rc == CURLE_OK) ? resp : "";
+    auto resp = HttpClient::post(url, body, timeout_s, 3);
+    return (resp.curl_code == 0) ? resp.body : "";
 }
 
 // --- dispatcher --------------------------------------------------------------
@@ -243,33 +222,43 @@ nlohmann::json snapshot_cockroachdb(const DbConnection& conn) {
     return j;
 }
 
+nlohmann::json delta(const nlohmann::json& before, const nlohmann::json& after) {
+    nlohmann::json d = nlohmann::json::object();
+    auto b = before.find("data");
+    auto a = after.find("data");
+    if (b == before.end() || a == after.end() || !b->is_object() || !a->is_object()) return d;
+    for (const auto& [key, av] : a->items()) {
+        auto bv = b->find(key);
+        if (bv == b->end()) continue;
+        if (av.is_number_integer() && bv->is_number_integer()) {
+            d[key] = av.get<int64_t>() - bv->get<int64_t>();
+        } else if (av.is_number() && bv->is_number()) {
+            d[key] = av.get<double>() - bv->get<double>();
+        }
+    }
+    return d;
+}
+
 // =============================================================================
 // Redis: MEMORY STATS decomposition, DBSIZE
+// In cluster mode every master is queried and the counters are summed.
 // =============================================================================
 
-nlohmann::json snapshot_redis(const DbConnection& conn) {
-    nlohmann::json j;
-
 #ifdef HAS_HIREDIS
-    struct timeval tv = {3, 0};
-    redisContext* ctx = redisConnectWithTimeout(conn.host.c_str(), conn.port, tv);
-    if (!ctx || ctx->err) {
-        if (ctx) { j["error"] = ctx->errstr; redisFree(ctx); }
-        return j;
-    }
-
+static void redis_node_stats(redisContext* ctx, nlohmann::json& j, int& ratio_nodes) {
     // DBSIZE (total key count)
     {
         redisReply* reply = static_cast<redisReply*>(redisCommand(ctx, "DBSIZE"));
         if (reply && reply->type == REDIS_REPLY_INTEGER)
-            j["dbsize"] = reply->integer;
+            j["dbsize"] = j.value("dbsize", int64_t{0}) + reply->integer;
         if (reply) freeReplyObject(reply);
     }
 
-    // MEMORY STATS (Redis 4.0+ memory breakdown)
+    // MEMORY STATS (Redis 4.0+ memory breakdown; RESP3 may return a map)
     {
         redisReply* reply = static_cast<redisReply*>(redisCommand(ctx, "MEMORY STATS"));
-        if (reply && reply->type == REDIS_REPLY_ARRAY) {
+        if (reply && (reply->type == REDIS_REPLY_ARRAY || reply->type == REDIS_REPLY_MAP)) {
+            bool counted_ratio = false;
             for (size_t i = 0; i + 1 < reply->elements; i += 2) {
                 if (reply->element[i]->type != REDIS_REPLY_STRING) continue;
                 std::string key(reply->element[i]->str, reply->element[i]->len);
@@ -281,33 +270,83 @@ nlohmann::json snapshot_redis(const DbConnection& conn) {
                         key == "clients.slaves" || key == "clients.normal" ||
                         key == "aof.buffer" || key == "dataset.bytes" ||
                         key == "overhead.total" || key == "keys.count" ||
-                        key == "keys.bytes-per-key" || key == "fragmentation.bytes") {
-                        j[key] = val->integer;
+                        key == "fragmentation.bytes") {
+                        j[key] = j.value(key, int64_t{0}) + val->integer;
                     }
-                } else if (val->type == REDIS_REPLY_STRING) {
+                } else if (val->type == REDIS_REPLY_STRING || val->type == REDIS_REPLY_DOUBLE) {
                     if (key == "allocator.fragmentation.ratio" ||
                         key == "rss-overhead.ratio") {
-                        j[key] = std::strtod(val->str, nullptr);
+                        // Averaged over nodes below
+                        double v = val->type == REDIS_REPLY_DOUBLE ? val->dval
+                                                                   : std::strtod(val->str, nullptr);
+                        j[key] = j.value(key, 0.0) + v;
+                        counted_ratio = true;
                     }
                 }
             }
+            if (counted_ratio) ++ratio_nodes;
         }
         if (reply) freeReplyObject(reply);
     }
+}
+#endif
 
-    redisFree(ctx);
+nlohmann::json snapshot_redis(const DbConnection& conn) {
+    nlohmann::json j;
+
+#ifdef HAS_HIREDIS
+    redisContext* seed = redis_open(conn.host, conn.port, conn);
+    if (!seed) {
+        j["error"] = "connection failed";
+        return j;
+    }
+
+    int nodes = 0;
+    int ratio_nodes = 0;
+    {
+        RedisCluster cluster;
+        cluster.init(seed, conn, true);
+        for (int node : cluster.masters()) {
+            redis_node_stats(cluster.context(node), j, ratio_nodes);
+            ++nodes;
+        }
+    }
+    redisFree(seed);
+
+    j["nodes"] = nodes;
+    if (ratio_nodes > 1) {
+        for (const char* key : {"allocator.fragmentation.ratio", "rss-overhead.ratio"}) {
+            if (j.contains(key)) j[key] = j[key].get<double>() / ratio_nodes;
+        }
+    }
+    // Recomputed from the sums (MEMORY STATS reports it per node)
+    const int64_t keys = j.value("keys.count", int64_t{0});
+    if (keys > 0) j["keys.bytes-per-key"] = j.value("dataset.bytes", int64_t{0}) / keys;
 #endif
 
     return j;
 }
 
 // =============================================================================
-// Kafka: JMX RequestMetrics timing, log sizes (via Prometheus exporter)
+// Kafka: DescribeLogDirs sizes, JMX RequestMetrics timing (via Prometheus exporter)
 // =============================================================================
 
 nlohmann::json snapshot_kafka(const DbConnection& conn) {
     nlohmann::json j;
 
+    // Lab topic segment bytes straight from the brokers' log dirs
+    std::string user = conn.user, pass = conn.password;
+    if (const char* v = std::getenv("KAFKA_USER")) user = v;
+    if (const char* v = std::getenv("KAFKA_PASSWORD")) pass = v;
+    KafkaLogDirs log_dirs(conn.host, conn.port, user, pass);
+    KafkaLogDirSizes sizes;
+    const std::string prefix = conn.lab_schema.empty() ? "dedup-lab" : conn.lab_schema;
+    if (log_dirs.describe(prefix + "-", sizes)) {
+        j["log_dirs_logical_bytes"] = sizes.logical;
+        j["log_dirs_replica_bytes"] = sizes.replicas;
+        j["log_dirs_partitions"] = sizes.partitions;
+    }
+
     // JMX RequestMetrics from Strimzi Prometheus exporter (port 9404)
     std::string body = http_get("http://" + conn.host + ":9404/metrics", 5);
     if (body.empty()) return j;
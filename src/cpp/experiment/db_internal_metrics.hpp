@@ -13,8 +13,8 @@
 // Per-system queries:
 //   PostgreSQL:  pg_total_relation_size, pg_statio_all_tables, pg_stat_statements
 //   CockroachDB: pg_database_size, crdb_internal.kv_store_status, SHOW RANGES
-//   Redis:       MEMORY STATS decomposition, DBSIZE
-//   Kafka:       JMX RequestMetrics timing, log dir sizes
+//   Redis:       MEMORY STATS decomposition, DBSIZE (summed over masters)
+//   Kafka:       DescribeLogDirs lab topic sizes, JMX RequestMetrics timing
 //   MinIO:       minio_s3_ttfb_seconds_distribution, per-bucket sizes
 //   MariaDB:     INNODB_TABLESPACES sizes, performance_schema IO waits
 //   ClickHouse:  system.columns compression ratio, system.parts
@@ -31,6 +31,10 @@ namespace db_internal {
 // Called at stage boundaries (before/after) in data_loader.cpp.
 nlohmann::json snapshot(const DbConnection& conn);
 
+// after - before for every numeric field present in both snapshots' "data"
+// (e.g. Redis MEMORY STATS dataset.bytes growth of one stage)
+nlohmann::json delta(const nlohmann::json& before, const nlohmann::json& after);
+
 // Per-system snapshot implementations
 nlohmann::json snapshot_postgresql(const DbConnection& conn);
 nlohmann::json snapshot_cockroachdb(const DbConnection& conn);
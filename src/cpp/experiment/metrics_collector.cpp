@@ -1,4 +1,5 @@
 #include "metrics_collector.hpp"
+#include "../connectors/http_client.hpp"
 #include "../utils/logger.hpp"
 #include <curl/curl.h>
 #include <nlohmann/json.hpp>
@@ -8,62 +9,47 @@
 
 namespace dedup {
 
-static size_t write_cb(char* ptr, size_t size, size_t nmemb, std::string* data) {
-    data->append(ptr, size * nmemb);
-    return size * nmemb;
-}
-
 std::string MetricsCollector::prometheus_query(const std::string& query) {
 #ifdef DEDUP_DRY_RUN
     LOG_DBG("[metrics] DRY RUN query: %s", query.c_str());
     return R"({"data":{"result":[{"value":[0,"0"]}]}})";
 #endif
 
-    CURL* curl = curl_easy_init();
-    if (!curl) return "";
-
     // URL-encode the PromQL query (braces, quotes, etc.)
-    char* escaped = curl_easy_escape(curl, query.c_str(), static_cast<int>(query.length()));
-    std::string url = prometheus_.url + "/api/v1/query?query=" + std::string(escaped);
-    curl_free(escaped);
+    std::string url;
+    {
+        auto h = HttpClient::acquire();
+        if (!h) return "";
+        char* escaped = curl_easy_escape(h.get(), query.c_str(), static_cast<int>(query.length()));
+        url = prometheus_.url + "/api/v1/query?query=" + std::string(escaped);
+        curl_free(escaped);
+    }
 
-    std::string response;
-    CURLcode res = CURLE_COULDNT_CONNECT;
+    HttpResponse resp;
 
     // Retry up to 3 times (Prometheus restarts frequently: 27 restarts observed)
     for (int attempt = 0; attempt < 3; ++attempt) {
-        response.clear();
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_cb);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-        curl_easy_setopt(curl, CURLOPT_TIMEOUT, 15L);
-        curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
-
-        res = curl_easy_perform(curl);
-        if (res == CURLE_OK) break;
+        resp = HttpClient::get(url, 15);
+        if (resp.curl_code == CURLE_OK) break;
 
         if (attempt < 2) {
             LOG_WRN("[metrics] Prometheus attempt %d failed: %s -- retrying in 2s",
-                attempt + 1, curl_easy_strerror(res));
+                attempt + 1, resp.error().c_str());
             std::this_thread::sleep_for(std::chrono::seconds(2));
         }
     }
 
-    long http_code = 0;
-    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-    curl_easy_cleanup(curl);
-
-    if (res != CURLE_OK) {
-        LOG_ERR("[metrics] Prometheus query failed after 3 attempts: %s", curl_easy_strerror(res));
+    if (resp.curl_code != CURLE_OK) {
+        LOG_ERR("[metrics] Prometheus query failed after 3 attempts: %s", resp.error().c_str());
         return "";
     }
 
-    if (http_code != 200) {
-        LOG_ERR("[metrics] Prometheus returned HTTP %ld for query: %s", http_code, query.c_str());
+    if (resp.status != 200) {
+        LOG_ERR("[metrics] Prometheus returned HTTP %ld for query: %s", resp.status, query.c_str());
         return "";
     }
 
-    return response;
+    return resp.body;
 }
 
 int64_t MetricsCollector::get_longhorn_actual_size(const std::string& volume_name) {
@@ -109,24 +95,12 @@ int64_t MetricsCollector::get_minio_physical_size(const std::string& minio_endpo
 
     // MinIO exposes Prometheus metrics at /minio/v2/metrics/cluster
     // We parse minio_bucket_usage_total_bytes{bucket="..."} lines
-    CURL* curl = curl_easy_init();
-    if (!curl) return -1;
-
-    std::string url = minio_endpoint + "/minio/v2/metrics/cluster";
-    std::string response;
-
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_cb);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 10L);
-
-    CURLcode res = curl_easy_perform(curl);
-    curl_easy_cleanup(curl);
-
-    if (res != CURLE_OK) {
-        LOG_ERR("[metrics] MinIO metrics fetch failed: %s", curl_easy_strerror(res));
+    auto resp = HttpClient::get(minio_endpoint + "/minio/v2/metrics/cluster", 10);
+    if (resp.curl_code != CURLE_OK) {
+        LOG_ERR("[metrics] MinIO metrics fetch failed: %s", resp.error().c_str());
         return -1;
     }
+    const std::string& response = resp.body;
 
     // Parse Prometheus exposition format:
     // minio_bucket_usage_total_bytes{bucket="dedup-lab-u0",...} 123456
@@ -174,9 +148,6 @@ bool MetricsCollector::push_metric(const std::string& metric_name, double value,
 #endif
 
     // Push to Prometheus Pushgateway (Grafana reads from Prometheus)
-    CURL* curl = curl_easy_init();
-    if (!curl) return false;
-
     const std::string& pt = payload_type.empty() ? "unknown" : payload_type;
     std::string url = grafana_.url + "/metrics/job/dedup-test"
                       "/db_system/" + db_system
@@ -188,14 +159,7 @@ bool MetricsCollector::push_metric(const std::string& metric_name, double value,
     body << metric_name << " " << value << "\n";
     std::string body_str = body.str();
 
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body_str.c_str());
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 10L);
-
-    CURLcode res = curl_easy_perform(curl);
-    curl_easy_cleanup(curl);
-
-    return res == CURLE_OK;
+    return HttpClient::post(url, body_str, 10).curl_code == CURLE_OK;
 }
 
 } // namespace dedup
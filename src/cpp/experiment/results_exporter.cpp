@@ -328,8 +328,8 @@ void ResultsExporter::export_results_csv(
         return;
     }
 
-    // Header (25 columns)
-    csv << "system,payload_type,dup_grade,insertion_mode,stage,"
+    // Header (26 columns)
+    csv << "system,payload_type,dup_grade,insertion_mode,variant,stage,"
         << "duration_ms,rows_affected,bytes_logical,"
         << "logical_size_before,logical_size_after,"
         << "phys_size_before,phys_size_after,phys_delta,"
@@ -357,6 +357,7 @@ void ResultsExporter::export_results_csv(
             << r.payload_type << ","
             << r.dup_grade << ","
             << r.insertion_mode << ","
+            << r.variant << ","
             << r.stage << ","
             << (r.duration_ns / 1000000) << ","
             << r.rows_affected << ","
@@ -80,7 +80,17 @@ static void print_usage(const char* prog) {
         "  --checkpoint-dir D  Directory for checkpoint files (enables resume)\n"
         "  --run-id N          Run identifier (1,2,3) for checkpoint tracking\n"
         "  --max-retries N     Max retries per system on connection loss (default: 3)\n"
-        "  --insertion-mode M  Insertion mode: blob, native, or both (default: blob)\n  --repeat-db NAME    Repeat only this DB (invalidates its checkpoints)\n  --verbose           Enable debug logging\n"
+        "  --insertion-mode M  Insertion mode: blob, native, or both (default: blob)\n  --repeat-db NAME    Repeat only this DB (invalidates its checkpoints)\n"
+        "  --pg-pipeline-depth N  libpq pipeline depth for PostgreSQL/CockroachDB\n"
+        "                      per-file stages (default: 0 = synchronous)\n"
+        "  --pg-parallelism N  Connections per PostgreSQL/CockroachDB load stage\n"
+        "                      (default: 1)\n"
+        "  --redis-pipeline-depth N  Commands per hiredis pipeline flush\n"
+        "                      (default: 0 = one round trip per key)\n"
+        "  --kafka-acks A      Kafka producer acks: all, 1 or 0 (default: all)\n"
+        "  --minio-concurrency N  Concurrent PUTs in MinIO bulk upload (default: 32)\n"
+        "  --minio-part-size MB  MinIO multipart part size in MiB (default: 16)\n"
+        "  --verbose           Enable debug logging\n"
         "  --help              Show this help\n"
         "\n"
         "SAFETY: This program operates on SEPARATE lab schemas.\n"
@@ -122,6 +132,12 @@ int main(int argc, char* argv[]) {
     int max_retries = 3;
     std::string insertion_mode_str = "blob";
     std::string repeat_db;
+    int pg_pipeline_depth = -1;  // -1 = keep config value
+    int pg_parallelism = -1;     // -1 = keep config value
+    int redis_pipeline_depth = -1;  // -1 = keep config value
+    std::string kafka_acks;         // empty = keep config value
+    int minio_concurrency = -1;     // -1 = keep config value
+    int minio_part_size = -1;       // -1 = keep config value
 
 #ifdef DEDUP_DRY_RUN
     dry_run = true;
@@ -167,6 +183,18 @@ int main(int argc, char* argv[]) {
             insertion_mode_str = argv[++i];
         } else if (std::strcmp(argv[i], "--repeat-db") == 0 && i + 1 < argc) {
             repeat_db = argv[++i];
+        } else if (std::strcmp(argv[i], "--pg-pipeline-depth") == 0 && i + 1 < argc) {
+            pg_pipeline_depth = std::stoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--pg-parallelism") == 0 && i + 1 < argc) {
+            pg_parallelism = std::stoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--redis-pipeline-depth") == 0 && i + 1 < argc) {
+            redis_pipeline_depth = std::stoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--kafka-acks") == 0 && i + 1 < argc) {
+            kafka_acks = argv[++i];
+        } else if (std::strcmp(argv[i], "--minio-concurrency") == 0 && i + 1 < argc) {
+            minio_concurrency = std::stoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--minio-part-size") == 0 && i + 1 < argc) {
+            minio_part_size = std::stoi(argv[++i]);
         } else if (std::strcmp(argv[i], "--dry-run") == 0) {
             dry_run = true;
         } else if (std::strcmp(argv[i], "--verbose") == 0) {
@@ -199,6 +227,15 @@ int main(int argc, char* argv[]) {
     cfg.results_dir = results_dir;
     cfg.lab_schema = lab_schema;
     cfg.dry_run = dry_run;
+    if (pg_pipeline_depth >= 0) cfg.postgres.pipeline_depth = pg_pipeline_depth;
+    if (pg_parallelism >= 1) cfg.postgres.parallelism = pg_parallelism;
+    if (redis_pipeline_depth >= 0) cfg.redis.pipeline_depth = redis_pipeline_depth;
+    if (!kafka_acks.empty()) cfg.kafka.acks = kafka_acks;
+    if (minio_concurrency >= 1) cfg.minio.upload_concurrency = minio_concurrency;
+    if (minio_part_size >= 1) {
+        cfg.minio.part_size_mb = minio_part_size;
+        cfg.minio.part_sizes_mb.clear();
+    }
 
     // Parse insertion mode (native adapter extension)
     dedup::InsertionMode insertion_mode = dedup::parse_insertion_mode(insertion_mode_str);
@@ -291,19 +328,19 @@ int main(int argc, char* argv[]) {
         std::shared_ptr<dedup::DbConnector> conn;
         switch (db.system) {
             case dedup::DbSystem::POSTGRESQL:
-                conn = std::make_shared<dedup::PostgresConnector>(dedup::DbSystem::POSTGRESQL);
+                conn = std::make_shared<dedup::PostgresConnector>(dedup::DbSystem::POSTGRESQL, cfg.postgres);
                 break;
             case dedup::DbSystem::COCKROACHDB:
-                conn = std::make_shared<dedup::PostgresConnector>(dedup::DbSystem::COCKROACHDB);
+                conn = std::make_shared<dedup::PostgresConnector>(dedup::DbSystem::COCKROACHDB, cfg.postgres);
                 break;
             case dedup::DbSystem::REDIS:
-                conn = std::make_shared<dedup::RedisConnector>();
+                conn = std::make_shared<dedup::RedisConnector>(cfg.redis);
                 break;
             case dedup::DbSystem::KAFKA:
-                conn = std::make_shared<dedup::KafkaConnector>();
+                conn = std::make_shared<dedup::KafkaConnector>(cfg.kafka);
                 break;
             case dedup::DbSystem::MINIO:
-                conn = std::make_shared<dedup::MinioConnector>();
+                conn = std::make_shared<dedup::MinioConnector>(cfg.minio);
                 break;
             case dedup::DbSystem::MARIADB:
                 conn = std::make_shared<dedup::MariaDBConnector>();
@@ -452,42 +489,57 @@ int main(int argc, char* argv[]) {
             std::vector<dedup::ExperimentResult> system_results;
             bool had_conn_error = false;
 
-            for (auto pt : cfg.payload_types) {
-                std::string pt_data_dir = data_dir + "/" + dedup::payload_type_str(pt);
-                LOG_INF("=== %s / %s (data: %s) ===",
-                    sys_name.c_str(), dedup::payload_type_str(pt), pt_data_dir.c_str());
+            // Variant dimension (e.g. PostgreSQL storage strategies): repeat all
+            // payload types once per configured variant; none = default only.
+            std::vector<std::string> variants = entry.connector->variants();
+            if (variants.empty()) variants.emplace_back();
 
-                if (cfg.metrics_trace.enabled) {
-                    trace.publish_event({dedup::now_ms(), "system_start", sys_name,
-                        dedup::payload_type_str(pt), "", "", ""});
+            for (const auto& variant : variants) {
+                if (had_conn_error) break;
+                if (!entry.connector->select_variant(variant)) {
+                    LOG_ERR("%s: cannot select variant %s -- skipping",
+                        sys_name.c_str(), variant.c_str());
+                    continue;
                 }
 
-                auto results = loader.run_full_experiment(
-                    *entry.connector, entry.db_conn, pt_data_dir, lab_schema, grades, pt);
+                for (auto pt : cfg.payload_types) {
+                    std::string pt_data_dir = data_dir + "/" + dedup::payload_type_str(pt);
+                    LOG_INF("=== %s / %s (data: %s) ===",
+                        sys_name.c_str(), dedup::payload_type_str(pt), pt_data_dir.c_str());
 
-                // Check for fatal connection loss in results
-                for (const auto& r : results) {
-                    if (!r.error.empty() &&
-                        r.error.find("CONNECTION_LOST") != std::string::npos) {
-                        had_conn_error = true;
-                        break;
+                    if (cfg.metrics_trace.enabled) {
+                        trace.publish_event({dedup::now_ms(), "system_start", sys_name,
+                            dedup::payload_type_str(pt), "", "", ""});
                     }
-                }
 
-                if (cfg.metrics_trace.enabled) {
-                    trace.publish_event({dedup::now_ms(), "system_end", sys_name,
-                        dedup::payload_type_str(pt), "", "",
-                        "{\"runs\":" + std::to_string(results.size()) + "}"});
-                }
+                    auto results = loader.run_full_experiment(
+                        *entry.connector, entry.db_conn, pt_data_dir, lab_schema, grades, pt);
 
-                if (had_conn_error) {
-                    LOG_ERR("[Recovery] Connection lost during %s / %s -- will retry system",
-                        sys_name.c_str(), dedup::payload_type_str(pt));
-                    break;
-                }
+                    // Check for fatal connection loss in results
+                    for (const auto& r : results) {
+                        if (!r.error.empty() &&
+                            r.error.find("CONNECTION_LOST") != std::string::npos) {
+                            had_conn_error = true;
+                            break;
+                        }
+                    }
 
-                system_results.insert(system_results.end(), results.begin(), results.end());
+                    if (cfg.metrics_trace.enabled) {
+                        trace.publish_event({dedup::now_ms(), "system_end", sys_name,
+                            dedup::payload_type_str(pt), "", "",
+                            "{\"runs\":" + std::to_string(results.size()) + "}"});
+                    }
+
+                    if (had_conn_error) {
+                        LOG_ERR("[Recovery] Connection lost during %s / %s -- will retry system",
+                            sys_name.c_str(), dedup::payload_type_str(pt));
+                        break;
+                    }
+
+                    system_results.insert(system_results.end(), results.begin(), results.end());
+                }
             }
+            entry.connector->select_variant("");
 
             if (!had_conn_error) {
                 // All payload types completed successfully for this system
@@ -543,28 +595,44 @@ int main(int argc, char* argv[]) {
                 std::vector<dedup::ExperimentResult> system_results;
                 bool had_conn_error = false;
 
-                for (auto pt : cfg.payload_types) {
-                    std::string pt_data_dir = data_dir + "/" + dedup::payload_type_str(pt);
-                    LOG_INF("=== NATIVE %s / %s ===", sys_name.c_str(), dedup::payload_type_str(pt));
+                // Variant dimension (PostgreSQL storage strategies, Redis record
+                // encodings): repeat all payload types once per configured
+                // variant; none = default only.
+                std::vector<std::string> variants = entry.connector->native_variants();
+                if (variants.empty()) variants.emplace_back();
 
-                    if (cfg.metrics_trace.enabled) {
-                        trace.publish_event({dedup::now_ms(), "native_system_start", sys_name,
-                            dedup::payload_type_str(pt), "", "", ""});
+                for (const auto& variant : variants) {
+                    if (had_conn_error) break;
+                    if (!entry.connector->select_variant(variant)) {
+                        LOG_ERR("[Native] %s: cannot select variant %s -- skipping",
+                            sys_name.c_str(), variant.c_str());
+                        continue;
                     }
 
-                    auto results = loader.run_native_experiment(
-                        *entry.connector, entry.db_conn, pt_data_dir, lab_schema, grades, pt);
+                    for (auto pt : cfg.payload_types) {
+                        std::string pt_data_dir = data_dir + "/" + dedup::payload_type_str(pt);
+                        LOG_INF("=== NATIVE %s / %s ===", sys_name.c_str(), dedup::payload_type_str(pt));
 
-                    for (const auto& r : results) {
-                        if (!r.error.empty() && r.error.find("CONNECTION_LOST") != std::string::npos) {
-                            had_conn_error = true;
-                            break;
+                        if (cfg.metrics_trace.enabled) {
+                            trace.publish_event({dedup::now_ms(), "native_system_start", sys_name,
+                                dedup::payload_type_str(pt), "", "", ""});
                         }
-                    }
 
-                    if (had_conn_error) break;
-                    system_results.insert(system_results.end(), results.begin(), results.end());
+                        auto results = loader.run_native_experiment(
+                            *entry.connector, entry.db_conn, pt_data_dir, lab_schema, grades, pt);
+
+                        for (const auto& r : results) {
+                            if (!r.error.empty() && r.error.find("CONNECTION_LOST") != std::string::npos) {
+                                had_conn_error = true;
+                                break;
+                            }
+                        }
+
+                        if (had_conn_error) break;
+                        system_results.insert(system_results.end(), results.begin(), results.end());
+                    }
                 }
+                entry.connector->select_variant("");
 
                 if (!had_conn_error) {
                     all_results.insert(all_results.end(),
@@ -0,0 +1,82 @@
+#pragma once
+// Read-only memory mapping of a whole file (RAII, move-only)
+// Pages are faulted in by whoever reads them first (e.g. librdkafka's broker
+// thread for zero-copy produce); MADV_WILLNEED starts readahead early.
+#include <cstddef>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace dedup {
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& path) { open(path); }
+    ~MappedFile() { reset(); }
+
+    MappedFile(MappedFile&& o) noexcept : data_(o.data_), size_(o.size_), ok_(o.ok_) {
+        o.data_ = nullptr;
+        o.size_ = 0;
+        o.ok_ = false;
+    }
+    MappedFile& operator=(MappedFile&& o) noexcept {
+        if (this != &o) {
+            reset();
+            data_ = o.data_;
+            size_ = o.size_;
+            ok_ = o.ok_;
+            o.data_ = nullptr;
+            o.size_ = 0;
+            o.ok_ = false;
+        }
+        return *this;
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Empty files are valid with data() == nullptr
+    bool open(const std::string& path) {
+        reset();
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        struct stat st{};
+        if (::fstat(fd, &st) == 0) {
+            size_ = static_cast<size_t>(st.st_size);
+            if (size_ == 0) {
+                ok_ = true;
+            } else {
+                void* p = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+                if (p != MAP_FAILED) {
+                    ::madvise(p, size_, MADV_WILLNEED);
+                    data_ = p;
+                    ok_ = true;
+                } else {
+                    size_ = 0;
+                }
+            }
+        }
+        ::close(fd);  // the mapping keeps the file referenced
+        return ok_;
+    }
+
+    void reset() noexcept {
+        if (data_) ::munmap(data_, size_);
+        data_ = nullptr;
+        size_ = 0;
+        ok_ = false;
+    }
+
+    [[nodiscard]] const char* data() const noexcept { return static_cast<const char*>(data_); }
+    [[nodiscard]] size_t size() const noexcept { return size_; }
+    [[nodiscard]] bool ok() const noexcept { return ok_; }
+
+private:
+    void* data_ = nullptr;
+    size_t size_ = 0;
+    bool ok_ = false;
+};
+
+} // namespace dedup
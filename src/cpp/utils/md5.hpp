@@ -0,0 +1,178 @@
+#pragma once
+// MD5 (RFC 1321) -- Pure C++ implementation for S3 Content-MD5 headers
+// (DeleteObjects requires one). Not used for fingerprinting.
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace dedup {
+
+class MD5 {
+public:
+    static constexpr size_t DIGEST_SIZE = 16;
+    static constexpr size_t BLOCK_SIZE = 64;
+
+    MD5() noexcept { reset(); }
+
+    void reset() noexcept {
+        state_[0] = 0x67452301; state_[1] = 0xefcdab89;
+        state_[2] = 0x98badcfe; state_[3] = 0x10325476;
+        count_ = 0;
+        buf_len_ = 0;
+    }
+
+    void update(const void* data, size_t len) noexcept {
+        auto* ptr = static_cast<const uint8_t*>(data);
+        count_ += len;
+
+        if (buf_len_ > 0) {
+            size_t fill = BLOCK_SIZE - buf_len_;
+            if (len < fill) {
+                std::memcpy(buf_ + buf_len_, ptr, len);
+                buf_len_ += len;
+                return;
+            }
+            std::memcpy(buf_ + buf_len_, ptr, fill);
+            transform(buf_);
+            ptr += fill;
+            len -= fill;
+            buf_len_ = 0;
+        }
+
+        while (len >= BLOCK_SIZE) {
+            transform(ptr);
+            ptr += BLOCK_SIZE;
+            len -= BLOCK_SIZE;
+        }
+
+        if (len > 0) {
+            std::memcpy(buf_, ptr, len);
+            buf_len_ = len;
+        }
+    }
+
+    std::array<uint8_t, DIGEST_SIZE> finalize() noexcept {
+        // Pad message: append 1 bit, zeros, then 64-bit little-endian length
+        uint64_t bits = count_ * 8;
+        uint8_t pad = 0x80;
+        update(&pad, 1);
+
+        pad = 0x00;
+        while (buf_len_ != 56) {
+            update(&pad, 1);
+        }
+
+        uint8_t len_le[8];
+        for (int i = 0; i < 8; ++i) {
+            len_le[i] = static_cast<uint8_t>(bits & 0xFF);
+            bits >>= 8;
+        }
+        update(len_le, 8);
+
+        std::array<uint8_t, DIGEST_SIZE> digest{};
+        for (int i = 0; i < 4; ++i) {
+            digest[i * 4 + 0] = static_cast<uint8_t>(state_[i]);
+            digest[i * 4 + 1] = static_cast<uint8_t>(state_[i] >> 8);
+            digest[i * 4 + 2] = static_cast<uint8_t>(state_[i] >> 16);
+            digest[i * 4 + 3] = static_cast<uint8_t>(state_[i] >> 24);
+        }
+        return digest;
+    }
+
+    // Convenience: hash data and return raw bytes
+    static std::array<uint8_t, DIGEST_SIZE> hash(const void* data, size_t len) {
+        MD5 ctx;
+        ctx.update(data, len);
+        return ctx.finalize();
+    }
+
+    // Convenience: hash data and return the digest base64-encoded, as the
+    // Content-MD5 header wants it
+    static std::string hash_base64(const void* data, size_t len) {
+        static constexpr char table[] =
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        auto d = hash(data, len);
+        std::string out;
+        size_t i = 0;
+        for (; i + 2 < DIGEST_SIZE; i += 3) {
+            uint32_t n = (d[i] << 16) | (d[i + 1] << 8) | d[i + 2];
+            out += table[(n >> 18) & 63];
+            out += table[(n >> 12) & 63];
+            out += table[(n >> 6) & 63];
+            out += table[n & 63];
+        }
+        // 16 bytes: one byte left over
+        uint32_t n = d[i] << 16;
+        out += table[(n >> 18) & 63];
+        out += table[(n >> 12) & 63];
+        out += "==";
+        return out;
+    }
+
+private:
+    uint32_t state_[4]{};
+    uint8_t buf_[BLOCK_SIZE]{};
+    size_t buf_len_ = 0;
+    uint64_t count_ = 0;
+
+    static constexpr uint32_t K[64] = {
+        0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee,
+        0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+        0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be,
+        0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+        0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa,
+        0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+        0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed,
+        0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+        0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c,
+        0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+        0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05,
+        0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+        0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039,
+        0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+        0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1,
+        0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+    };
+
+    static constexpr int S[64] = {
+        7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+        5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20,
+        4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+        6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21
+    };
+
+    static constexpr uint32_t rotl(uint32_t x, int n) noexcept {
+        return (x << n) | (x >> (32 - n));
+    }
+
+    void transform(const uint8_t* block) noexcept {
+        uint32_t M[16];
+
+        // Load message block as little-endian 32-bit words
+        for (int i = 0; i < 16; ++i) {
+            M[i] = (static_cast<uint32_t>(block[i * 4]))
+                 | (static_cast<uint32_t>(block[i * 4 + 1]) << 8)
+                 | (static_cast<uint32_t>(block[i * 4 + 2]) << 16)
+                 | (static_cast<uint32_t>(block[i * 4 + 3]) << 24);
+        }
+
+        uint32_t a = state_[0], b = state_[1], c = state_[2], d = state_[3];
+
+        for (int i = 0; i < 64; ++i) {
+            uint32_t f;
+            int g;
+            if (i < 16)      { f = (b & c) | (~b & d); g = i; }
+            else if (i < 32) { f = (d & b) | (~d & c); g = (5 * i + 1) % 16; }
+            else if (i < 48) { f = b ^ c ^ d;          g = (3 * i + 5) % 16; }
+            else             { f = c ^ (b | ~d);       g = (7 * i) % 16; }
+            f += a + K[i] + M[g];
+            a = d; d = c; c = b;
+            b += rotl(f, S[i]);
+        }
+
+        state_[0] += a; state_[1] += b; state_[2] += c; state_[3] += d;
+    }
+};
+
+} // namespace dedup